@@ -11,6 +11,7 @@
 #include "BRMeshRefine.H"
 #include "RefCountedPtr.H"
 #include "AMRMultiGrid.H"
+#include "AMRKrylovMultiGrid.H"
 
 #include "EBIndexSpace.H"
 #include "MFIndexSpace.H"
@@ -111,12 +112,16 @@ AmoebaParams()
 
   pp.get("output_interval",m_outputInterval);
   pp.get("output_prefix",m_outputPrefix);
+  m_ebisCacheDir = "";
+  pp.query("ebis_cache_dir",m_ebisCacheDir);
 
   pp.get("maxboxsize",m_maxBoxSize);
   pp.get("block_factor",m_blockFactor);
 
   pp.get("fill_ratio",m_fillRatio);
   m_nestingRadius = 2;
+  m_distributedClustering = false;
+  pp.query("distributed_clustering",m_distributedClustering);
 
   pp.get("mg_num_cycles",m_mgNumCycles);
   pp.get("mg_num_smooths",m_mgNumSmooths);
@@ -126,6 +131,12 @@ AmoebaParams()
   pp.get("mg_hang_toler",m_mgHangToler);
   pp.get("mg_iter_max",m_mgIterMax);
   pp.get("mg_num_precond_iter",m_mgNumPrecondIter);
+  m_mgKrylov = AMRKrylovMultiGrid<EBCellFAB>::KrylovNone;
+  pp.query("mg_krylov",m_mgKrylov);
+  m_mgFMG = false;
+  pp.query("mg_fmg",m_mgFMG);
+  m_mgExtrapolateGuess = false;
+  pp.query("mg_extrapolate_guess",m_mgExtrapolateGuess);
 
   m_numGhostEBISLayout = 4;
 
@@ -161,10 +172,12 @@ print()
   pout() << "\n";
   pout() << "output interval = " << m_outputInterval << "\n";
   pout() << "output prefix   = " << m_outputPrefix   << "\n";
+  pout() << "ebis cache dir  = " << m_ebisCacheDir   << "\n";
   pout() << "\n";
   pout() << "max box size = " << m_maxBoxSize  << "\n";
   pout() << "block factor = " << m_blockFactor << "\n";
   pout() << "fill ratio = " << m_fillRatio << "\n";
+  pout() << "distributed clustering = " << m_distributedClustering << "\n";
   pout() << "mg num cycles       = " << m_mgNumCycles      << "\n";
   pout() << "mg num smooths      = " << m_mgNumSmooths     << "\n";
   pout() << "mg relax type       = " << m_mgRelaxType      << "\n";
@@ -173,6 +186,9 @@ print()
   pout() << "mg hang toler       = " << m_mgHangToler      << "\n";
   pout() << "mg iter max         = " << m_mgIterMax        << "\n";
   pout() << "mg num precond iter = " << m_mgNumPrecondIter << "\n";
+  pout() << "mg krylov           = " << m_mgKrylov         << "\n";
+  pout() << "mg fmg              = " << m_mgFMG            << "\n";
+  pout() << "mg extrapolate guess = " << m_mgExtrapolateGuess << "\n";
   pout() << "\n";
 }
 
@@ -313,8 +329,10 @@ defineSolver(RefCountedPtr<EBBackwardEuler>& a_integrator, int a_ivol, int a_iva
   CH_TIME("AmoebaSolver::defineSolver");
 
   // This is the multigrid solver used for backward Euler
-  RefCountedPtr<AMRMultiGrid<LevelData<EBCellFAB > > >
-    solver(new AMRMultiGrid<LevelData<EBCellFAB> >);
+  // (AMRKrylovMultiGrid with KrylovNone is plain AMRMultiGrid)
+  AMRKrylovMultiGrid<EBCellFAB>* krylovSolver = new AMRKrylovMultiGrid<EBCellFAB>;
+  krylovSolver->setKrylovMethod(m_params.m_mgKrylov);
+  RefCountedPtr<AMRMultiGrid<LevelData<EBCellFAB > > > solver(krylovSolver);
 
 
   // Set the verbosity of the bottom solver for multigrid
@@ -354,6 +372,7 @@ defineSolver(RefCountedPtr<EBBackwardEuler>& a_integrator, int a_ivol, int a_iva
                               m_params.m_mgToler,
                               m_params.m_mgHangToler,
                               normThresh);
+  solver->setInitialGuess(m_params.m_mgFMG, m_params.m_mgExtrapolateGuess);
 
   solver->m_verbosity = 3;
   solver->init(m_scalOld[a_ivol],m_scalRHS[a_ivol],m_params.m_numLevels-1,0);
@@ -643,12 +662,30 @@ initGeometry()
       fineDx /= m_params.m_refRatio[ilev];
     }
 
-  // Create the implicit function for one of the known geometries
-  BaseIF* geometry;
-  MFIndexSpace mfIndexSpace;
+  // Reuse a stored index space for this geometry if there is one
+  bool useCache = (m_params.m_ebisCacheDir.size() > 0);
+  unsigned long long geomHash = 0;
+  if (useCache)
+    {
+      BaseIF* phase0 = makeMultiSphereIF();
+      geomHash = geometryHash(*phase0, fineDomain.domainBox(), m_params.m_loCorner,
+                              fineDx[0], m_params.m_numLevels);
+      delete phase0;
+    }
+
+  if (!useCache || !readCachedComponents(m_volumes, m_params.m_ebisCacheDir, geomHash, fineDomain))
+    {
+      // Create the implicit function for one of the known geometries
+      BaseIF* geometry;
+      MFIndexSpace mfIndexSpace;
 
-  geometry = makeMultiSphereGeometry(mfIndexSpace, fineDomain.domainBox(), m_params.m_loCorner, fineDx[0]);
-  getConnectedComponents(m_volumes, mfIndexSpace);
+      geometry = makeMultiSphereGeometry(mfIndexSpace, fineDomain.domainBox(), m_params.m_loCorner, fineDx[0]);
+      getConnectedComponents(m_volumes, mfIndexSpace);
+      if (useCache)
+        {
+          writeCachedComponents(m_volumes, m_params.m_ebisCacheDir, geomHash);
+        }
+    }
   getDiffusionConstants();
 
 }
@@ -703,6 +740,7 @@ initIndexSpace()
                         m_params.m_blockFactor,
                         m_params.m_nestingRadius,
                         m_params.m_maxBoxSize);
+      meshRefine.setDistributedClustering(m_params.m_distributedClustering);
 
       // Compute the second finest domain
       ProblemDomain secondFinestDomain = m_params.m_coarsestDomain;
@@ -724,6 +762,23 @@ initIndexSpace()
           tags[m_params.m_numLevels-2] |= tagsVol;
         }
 
+      if (m_params.m_distributedClustering)
+        {
+          // every rank computed all the tags; keep only those under the
+          // coarsest boxes this rank owns
+          int nref = 1;
+          for (int ilev = 0; ilev < m_params.m_numLevels-2; ilev++)
+            {
+              nref *= m_params.m_refRatio[ilev];
+            }
+          IntVectSet owned;
+          for (DataIterator dit = m_grids[0].dataIterator(); dit.ok(); ++dit)
+            {
+              owned |= refine(m_grids[0][dit()], nref);
+            }
+          tags[m_params.m_numLevels-2] &= owned;
+        }
+
 
       Vector<Vector<Box> > oldBoxes(m_params.m_numLevels);
       Vector<Vector<Box> > newBoxes;
@@ -769,6 +824,8 @@ initIndexSpace()
             }
         }
     }
+  //grids have changed so cached level grids and interpolators are stale
+  m_eblgCache.resize(0);
   ParmParse pp;
   if(pp.contains("abr_file_output_name"))
     {
@@ -797,39 +854,29 @@ getEBLGAndQuadCFI(Vector<EBLevelGrid>                   & a_ebLevelGrids,
                   Vector<RefCountedPtr<EBQuadCFInterp> >& a_quadCFInterp,
                   int a_ivol, int a_ncomp)
 {
-  a_ebLevelGrids.resize(m_grids.size());
-  a_quadCFInterp.resize(m_grids.size());
-
-  // Define the data holders and interpolators
-  ProblemDomain levelDomain = m_params.m_coarsestDomain;
-  ProblemDomain coarserDomain;
-  for (int ilev = 0; ilev < m_grids.size(); ilev++)
+  CH_TIME("AmoebaSolver::getEBLGAndQuadCFI");
+  //these only depend on the grids so they are built once and reused
+  //until the grids change
+  if (m_eblgCache.size() != m_volumes.size())
     {
-      a_ebLevelGrids[ilev].define(m_grids[ilev],m_ebisl[a_ivol][ilev],levelDomain);
-
-      if (ilev > 0)
-        {
-          int numVariables = a_ncomp;
-
-          a_quadCFInterp[ilev] = RefCountedPtr<EBQuadCFInterp>
-            (new EBQuadCFInterp(m_grids[ilev],
-                                m_grids[ilev-1],
-                                m_ebisl[a_ivol][ilev],
-                                m_ebisl[a_ivol][ilev-1],
-                                coarserDomain,
-                                m_params.m_refRatio[ilev-1],
-                                numVariables,
-                                *(a_ebLevelGrids[ilev].getCFIVS()),
-                                &(*m_volumes[a_ivol])));
-        }
-
-      coarserDomain = levelDomain;
-
-      if (ilev < m_grids.size()-1)
-        {
-          levelDomain.refine(m_params.m_refRatio[ilev]);
-        }
+      m_eblgCache.resize(m_volumes.size());
+    }
+  if (m_eblgCache[a_ivol].isNull())
+    {
+      m_eblgCache[a_ivol] = RefCountedPtr<EBLevelGridCache>(new EBLevelGridCache());
     }
+  EBLevelGridCache& cache = *m_eblgCache[a_ivol];
+  if (!cache.isCurrent(m_grids, m_ebisl[a_ivol], &(*m_volumes[a_ivol])))
+    {
+      cache.define(m_grids,
+                   m_ebisl[a_ivol],
+                   m_params.m_coarsestDomain,
+                   m_params.m_refRatio,
+                   &(*m_volumes[a_ivol]));
+    }
+
+  a_ebLevelGrids = cache.getEBLevelGrids();
+  a_quadCFInterp = cache.getQuadCFInterp(a_ncomp);
 }
 
 //////
@@ -11,6 +11,7 @@
 #include "BRMeshRefine.H"
 #include "RefCountedPtr.H"
 #include "AMRMultiGrid.H"
+#include "AMRKrylovMultiGrid.H"
 
 #include "EBIndexSpace.H"
 #include "MFIndexSpace.H"
@@ -31,6 +32,7 @@
 #include "NeumannPoissonDomainBC.H"
 #include "NeumannPoissonEBBC.H"
 #include "EBMenagerieUtils.H"
+#include "MitochondriaIF.H"
 #include "MitochondriaSolver.H"
 #include "AMRBoxesAndRanksIO.H"
 #include "ParmParse.H"
@@ -114,6 +116,16 @@ MitochondriaParams::MitochondriaParams()
 
   pp.get("output_interval",m_outputInterval);
   pp.get("output_prefix",m_outputPrefix);
+  m_asyncOutput = false;
+  pp.query("async_output",m_asyncOutput);
+  m_asyncOutputDepth = 2;
+  pp.query("async_output_depth",m_asyncOutputDepth);
+  m_ebisCacheDir = "";
+  pp.query("ebis_cache_dir",m_ebisCacheDir);
+  m_loadBalanceInterval = 0;
+  pp.query("load_balance_interval",m_loadBalanceInterval);
+  m_loadBalanceThreshold = 1.1;
+  pp.query("load_balance_threshold",m_loadBalanceThreshold);
 
   pp.get("maxboxsize",m_maxBoxSize);
   pp.get("block_factor",m_blockFactor);
@@ -129,6 +141,15 @@ MitochondriaParams::MitochondriaParams()
   pp.get("mg_hang_toler",m_mgHangToler);
   pp.get("mg_iter_max",m_mgIterMax);
   pp.get("mg_num_precond_iter",m_mgNumPrecondIter);
+  m_mgKrylov = AMRKrylovMultiGrid<EBCellFAB>::KrylovNone;
+  pp.query("mg_krylov",m_mgKrylov);
+  m_mgFMG = false;
+  pp.query("mg_fmg",m_mgFMG);
+  m_mgExtrapolateGuess = false;
+  pp.query("mg_extrapolate_guess",m_mgExtrapolateGuess);
+
+  m_blockSolve = false;
+  pp.query("block_solve",m_blockSolve);
 
   m_numGhostEBISLayout = 4;
 
@@ -160,6 +181,11 @@ void MitochondriaParams::print()
   pout() << "\n";
   pout() << "output interval = " << m_outputInterval << "\n";
   pout() << "output prefix   = " << m_outputPrefix   << "\n";
+  pout() << "async output    = " << m_asyncOutput    << "\n";
+  pout() << "async out depth = " << m_asyncOutputDepth << "\n";
+  pout() << "ebis cache dir  = " << m_ebisCacheDir   << "\n";
+  pout() << "load balance interval  = " << m_loadBalanceInterval  << "\n";
+  pout() << "load balance threshold = " << m_loadBalanceThreshold << "\n";
   pout() << "\n";
   pout() << "max box size = " << m_maxBoxSize  << "\n";
   pout() << "block factor = " << m_blockFactor << "\n";
@@ -172,6 +198,10 @@ void MitochondriaParams::print()
   pout() << "mg hang toler       = " << m_mgHangToler      << "\n";
   pout() << "mg iter max         = " << m_mgIterMax        << "\n";
   pout() << "mg num precond iter = " << m_mgNumPrecondIter << "\n";
+  pout() << "mg krylov           = " << m_mgKrylov         << "\n";
+  pout() << "mg fmg              = " << m_mgFMG            << "\n";
+  pout() << "mg extrapolate guess = " << m_mgExtrapolateGuess << "\n";
+  pout() << "block solve         = " << m_blockSolve       << "\n";
   pout() << "\n";
 }
 
@@ -282,13 +312,16 @@ void MitochondriaSolver::initStencils()
 
 void MitochondriaSolver::defineSolver(RefCountedPtr<EBBackwardEuler>& a_integrator,
                                      int                             a_ivol,
-                                     int                             a_ivar)
+                                     int                             a_ivar,
+                                     int                             a_ncomp)
 {
   CH_TIME("MitochondriaSolver::defineSolver");
 
   // This is the multigrid solver used for backward Euler
-  RefCountedPtr<AMRMultiGrid<LevelData<EBCellFAB > > >
-    solver(new AMRMultiGrid<LevelData<EBCellFAB> >);
+  // (AMRKrylovMultiGrid with KrylovNone is plain AMRMultiGrid)
+  AMRKrylovMultiGrid<EBCellFAB>* krylovSolver = new AMRKrylovMultiGrid<EBCellFAB>;
+  krylovSolver->setKrylovMethod(m_params.m_mgKrylov);
+  RefCountedPtr<AMRMultiGrid<LevelData<EBCellFAB > > > solver(krylovSolver);
 
 
   // Set the verbosity of the bottom solver for multigrid
@@ -297,7 +330,7 @@ void MitochondriaSolver::defineSolver(RefCountedPtr<EBBackwardEuler>& a_integrat
   RefCountedPtr<AMRLevelOpFactory<LevelData<EBCellFAB> > > operatorFactory;
   RefCountedPtr<EBAMRPoissonOpFactory> opfact;
 
-  getConstantCoeffOpFactory(opfact, a_ivol, a_ivar);
+  getConstantCoeffOpFactory(opfact, a_ivol, a_ivar, a_ncomp);
 
   operatorFactory = opfact;
 
@@ -318,9 +351,18 @@ void MitochondriaSolver::defineSolver(RefCountedPtr<EBBackwardEuler>& a_integrat
                               m_params.m_mgToler,
                               m_params.m_mgHangToler,
                               normThresh);
+  solver->setInitialGuess(m_params.m_mgFMG, m_params.m_mgExtrapolateGuess);
 
   solver->m_verbosity = 3;
-  solver->init(m_scalOld[a_ivol],m_scalRHS[a_ivol],m_params.m_numLevels-1,0);
+  if (a_ncomp == 1)
+    {
+      solver->init(m_scalOld[a_ivol],m_scalRHS[a_ivol],m_params.m_numLevels-1,0);
+    }
+  else
+    {
+      CH_assert(a_ncomp == m_params.m_ncomp);
+      solver->init(m_solnOld[a_ivol],m_soursin[a_ivol],m_params.m_numLevels-1,0);
+    }
 
   // Create the backward Euler solver based on the multigrid solver
   a_integrator = RefCountedPtr<EBBackwardEuler>
@@ -399,25 +441,33 @@ Real
 MitochondriaSolver::
 getJ(const Real& Umat, const Real& Vmat, const Real& Ucyt, const Real& Vcyt)
 {
-  Real Jval = 0;
+  Real Jval;
+  getJ(&Jval, &Umat, &Vmat, &Ucyt, &Vcyt, 1);
+  return Jval;
+}
+///
+void
+MitochondriaSolver::
+getJ(Real* a_J, const Real* a_Umat, const Real* a_Vmat, const Real* a_Ucyt, const Real* a_Vcyt, int a_npts)
+{
   Real k  =  0.003162278;
   Real p  = 9.0;
   Real Vm = 250.;
+  Real sqrtkOverP = sqrt(k)/p;
+  Real eps = 1.0e-12;
   //from the email...
   // Jval  =  (Vm * ((k * Ucyt* Vmat) - (Umat * Vcyt)) / (Vcyt + (Ucyt * sqrt(k) / p)) / (Umat + (p * Vmat)));
-  // but I want to show a bit of caution
-  Real denom1 = (Vcyt + (Ucyt * sqrt(k) / p));
-  Real denom2 =  (Umat + (p * Vmat));
-  Real eps = 1.0e-12;
-  if((Abs(denom1) > eps) && (Abs(denom2) > eps))
-    {
-      Jval  =  (Vm * ((k * Ucyt* Vmat) - (Umat * Vcyt))) / denom1/denom2;
-    }
-  else
+  // but I want to show a bit of caution.
+  //no calls and no early exits in here so the compiler can vectorize it.
+  for (int ipt = 0; ipt < a_npts; ipt++)
     {
-      Jval = 0;
+      Real denom1 = (a_Vcyt[ipt] + (a_Ucyt[ipt] * sqrtkOverP));
+      Real denom2 = (a_Umat[ipt] + (p * a_Vmat[ipt]));
+      bool safe = ((Abs(denom1) > eps) && (Abs(denom2) > eps));
+      Real denom = safe ? denom1*denom2 : 1.0;
+      Real numer = (Vm * ((k * a_Ucyt[ipt]* a_Vmat[ipt]) - (a_Umat[ipt] * a_Vcyt[ipt])));
+      a_J[ipt] = safe ? numer/denom : 0.0;
     }
-  return Jval;
 }
 ///
 void
@@ -466,61 +516,187 @@ getFlux(Vector<Real>& flux, const Vector<Real>& thisVal, const Vector<Real>& oth
     }
   
 }
+///
+void
+MitochondriaSolver::
+getFlux(Real* a_flux, const Real* a_thisVal, const Real* a_otherVal, int a_npts, int ivol)
+{
+  //same assumptions as the pointwise version
+  CH_assert(m_params.m_ncomp == 2);
+  CH_assert((ivol == 0) || (ivol == 1));
+
+  const Real* Umat;
+  const Real* Vmat;
+  const Real* Ucyt;
+  const Real* Vcyt;
+  int imat = m_params.m_ivol_mat;
+  if(ivol == imat)
+    {
+      Umat =  a_thisVal;
+      Vmat =  a_thisVal + a_npts;
+      Ucyt = a_otherVal;
+      Vcyt = a_otherVal + a_npts;
+    }
+  else
+    {
+      Ucyt =  a_thisVal;
+      Vcyt =  a_thisVal + a_npts;
+      Umat = a_otherVal;
+      Vmat = a_otherVal + a_npts;
+    }
+
+  //J goes straight into the first component of the flux
+  Real* flux0 = a_flux;
+  Real* flux1 = a_flux + a_npts;
+  getJ(flux0, Umat, Vmat, Ucyt, Vcyt, a_npts);
+  Real sign = (ivol == imat) ? 1.0 : -1.0;
+  for (int ipt = 0; ipt < a_npts; ipt++)
+    {
+      Real J = flux0[ipt];
+      flux0[ipt] =  sign*J;
+      flux1[ipt] = -sign*J;
+    }
+}
+///
+void
+MitochondriaSolver::
+definePairing()
+{
+  CH_TIME("MitochondriaSolver::definePairing");
+
+  int nvol  = m_volumes.size();
+  int maxVoFs = 1;
+  m_pairing.resize(nvol);
+  for (int ivol = 0; ivol < nvol; ivol++)
+    {
+      m_pairing[ivol].resize(m_params.m_numLevels);
+      for (int ilev = 0; ilev < m_params.m_numLevels; ilev++)
+        {
+          m_pairing[ivol][ilev] = RefCountedPtr<LayoutData<InterfacePairing> >(new LayoutData<InterfacePairing>(m_grids[ilev]));
+          for (DataIterator dit =m_grids[ilev].dataIterator(); dit.ok(); ++dit)
+            {
+              InterfacePairing& pairing = (*m_pairing[ivol][ilev])[dit()];
+              pairing = InterfacePairing();
+
+              const BaseIVFAB<Real>& thisData = (*m_dataBou[ivol][ilev])[dit()];
+              const EBGraph& ebgraph =m_ebisl[ivol][ilev][dit()].getEBGraph();
+              Vector<long> unpaired;
+              pairing.m_otherStart.push_back(0);
+              for (VoFIterator vofit(thisData.getIVS(), ebgraph); vofit.ok(); ++vofit)
+                {
+                  const VolIndex& vof = vofit();
+                  const IntVect&  iv  = vof.gridIndex();
+                  int numOther = 0;
+                  for (int jvol = 0; jvol < nvol; jvol++)
+                    {
+                      if (jvol != ivol)
+                        {
+                          const BaseIVFAB<Real>& otherData = (*m_dataBou[jvol][ilev])[dit()];
+                          //the other volume is indexed with this volume's vof
+                          //so make sure that vof exists over there
+                          if (otherData.getIVS().contains(iv) &&
+                              (vof.cellIndex() < m_ebisl[jvol][ilev][dit()].numVoFs(iv)))
+                            {
+                              pairing.m_otherVol.push_back(jvol);
+                              pairing.m_otherOffset.push_back(otherData.offset(vof, 0));
+                              numOther++;
+                            }
+                        }
+                    }
+                  //if no other volume is found, this is in practice usually a regular cell
+                  //that has been labeled irregular.  it gets zero flux.
+                  if (numOther > 0)
+                    {
+                      pairing.m_thisOffset.push_back(thisData.offset(vof, 0));
+                      pairing.m_otherStart.push_back(pairing.m_otherVol.size());
+                    }
+                  else
+                    {
+                      unpaired.push_back(thisData.offset(vof, 0));
+                    }
+                }
+              pairing.m_numPaired = pairing.m_thisOffset.size();
+              pairing.m_thisOffset.append(unpaired);
+              maxVoFs = Max(maxVoFs, pairing.numVoFs());
+            }
+        }
+    }
+  m_pairScratch.resize(3*m_params.m_ncomp*maxVoFs);
+  m_pairData.resize(nvol);
+}
+///
 void MitochondriaSolver::setBoundaryValues()
 {
   CH_TIME("set_boundary_values");
+  CH_assert(m_pairing.size() == m_volumes.size());
 
   //use data extrapolated from the boundary to set boundary data values.
+  //the pairing table says which slots of the other volumes to average for each vof;
+  //values are gathered into component-major scratch so the flux is one pass over flat arrays.
+  int ncomp = m_params.m_ncomp;
   for (int ivol = 0; ivol < m_volumes.size(); ivol++)
     {
-      Real dxlev = m_params.m_dx;
       for (int ilev = 0; ilev < m_params.m_numLevels; ilev++)
         {
           for (DataIterator dit =m_grids[ilev].dataIterator(); dit.ok(); ++dit)
             {
-              const EBGraph& ebgraph =m_ebisl[ivol][ilev][dit()].getEBGraph();
-              const IntVectSet& ivs = (*m_bounVal[ivol][ilev])[dit()].getIVS();
-              for (VoFIterator vofit(ivs, ebgraph); vofit.ok(); ++vofit)
+              const InterfacePairing& pairing = (*m_pairing[ivol][ilev])[dit()];
+              const BaseIVFAB<Real>&  thisData = (*m_dataBou[ivol][ilev])[dit()];
+              BaseIVFAB<Real>&        bounVal  = (*m_bounVal[ivol][ilev])[dit()];
+              //both come from the same factory so the offsets are good for either one
+              CH_assert(bounVal.numVoFs() == thisData.numVoFs());
+              CH_assert(pairing.numVoFs() == thisData.numVoFs());
+
+              int npair = pairing.m_numPaired;
+              int nvofs = pairing.numVoFs();
+              Real* thisVal  = &m_pairScratch[0];
+              Real* otherVal = thisVal  + ncomp*npair;
+              Real* flux     = otherVal + ncomp*npair;
+              if (npair > 0)
                 {
-                  Vector<Real>  thisVal(m_params.m_ncomp, 0.);
-                  Vector<Real> otherVal(m_params.m_ncomp, 0.);
-                  bool found = false;
-                  Vector<Real> flux(m_params.m_ncomp, 0.0);
-                  for (int ivar = 0; ivar < m_params.m_ncomp; ivar++)
+                  const long* thisOffset  = &pairing.m_thisOffset[0];
+                  const int*  otherStart  = &pairing.m_otherStart[0];
+                  const int*  otherVol    = &pairing.m_otherVol[0];
+                  const long* otherOffset = &pairing.m_otherOffset[0];
+                  for (int ivar = 0; ivar < ncomp; ivar++)
                     {
-                      thisVal[ivar] = (*m_dataBou[ivol][ilev])[dit()](vofit(), ivar);
-                      // if there is another volume to grab from, grab away and average what I  get. 
-                      int nvals = 0;
                       for (int jvol = 0; jvol < m_volumes.size(); jvol++)
                         {
-                          if (jvol != ivol)
+                          m_pairData[jvol] = (*m_dataBou[jvol][ilev])[dit()].dataPtr(ivar);
+                        }
+                      const Real* thisPtr  = thisData.dataPtr(ivar);
+                      Real*       thisComp =  thisVal + ivar*npair;
+                      Real*      otherComp = otherVal + ivar*npair;
+                      for (int ipair = 0; ipair < npair; ipair++)
+                        {
+                          thisComp[ipair] = thisPtr[thisOffset[ipair]];
+                          // if there is more than one other volume, average what I get.
+                          Real sum = 0;
+                          for (int iother = otherStart[ipair]; iother < otherStart[ipair+1]; iother++)
                             {
-                              bool inIrreg = (*m_dataBou[jvol][ilev])[dit()].getIVS().contains(vofit().gridIndex());
-                              if(inIrreg)
-                                {
-                                  found = true;
-                                  otherVal[ivar] += (*m_dataBou[jvol][ilev])[dit()](vofit(), ivar);
-                                  nvals ++;
-                                }
+                              sum += m_pairData[otherVol[iother]][otherOffset[iother]];
                             }
+                          otherComp[ipair] = sum/(otherStart[ipair+1] - otherStart[ipair]);
                         }
-                      if(found && (nvals > 1)) otherVal[ivar] /= nvals;
                     }
-                  
-                  for(int ivar = 0; ivar < m_params.m_ncomp; ivar++) flux[ivar] = 0;
-                  //if !found, no other volumes found.   in practice, usually a regular cell 
-                  //that has been labeled irregular.
-                  if (found)
+
+                  getFlux(flux, thisVal, otherVal, npair, ivol);
+                }
+
+              for (int ivar = 0; ivar < ncomp; ivar++)
+                {
+                  Real*       bounPtr  = bounVal.dataPtr(ivar);
+                  const Real* fluxComp = flux + ivar*npair;
+                  for (int ivof = 0; ivof < npair; ivof++)
                     {
-                      getFlux(flux, thisVal, otherVal, ivol);
+                      bounPtr[pairing.m_thisOffset[ivof]] = fluxComp[ivof];
                     }
-                  for(int ivar = 0; ivar < m_params.m_ncomp; ivar++)
+                  for (int ivof = npair; ivof < nvofs; ivof++)
                     {
-                      (*m_bounVal[ivol][ilev])[dit()](vofit(), ivar) = flux[ivar];
+                      bounPtr[pairing.m_thisOffset[ivof]] = 0.;
                     }
                 }
             }
-          dxlev /= m_params.m_refRatio[ilev];
         }
     }
 }
@@ -570,6 +746,26 @@ void MitochondriaSolver::advanceOneVariable(int a_ivar)
     }
 }
 
+void MitochondriaSolver::advanceAllVariables()
+{
+  CH_TIME("advanceAllVariables");
+  //the operators know about all the components so no scratch space is needed
+  for (int ivol = 0; ivol < m_volumes.size(); ivol++)
+    {
+      pout() << "advancing all variables of volume " << ivol << " in time " << endl;
+
+      CH_TIME("integrator::onestep");
+
+      m_integrator[ivol][0]->oneStep(m_solnNew[ivol],
+                                     m_solnOld[ivol],
+                                     m_soursin[ivol],
+                                     m_params.m_dt,
+                                     0,
+                                     m_params.m_numLevels-1,
+                                     true);
+    }
+}
+
 void MitochondriaSolver::run()
 {
   CH_TIME("MitochondriaSolver::run");
@@ -577,6 +773,9 @@ void MitochondriaSolver::run()
   // Compute the number of time steps
   int numSteps = m_params.m_endTime / m_params.m_dt;
 
+  // Plotfiles are written in the background while the solve goes on
+  setEBHDF5Async(m_params.m_asyncOutput, m_params.m_asyncOutputDepth);
+
   // Iterate until the end time is reached
   int step;
   for (step = 0; step < numSteps; step++)
@@ -603,22 +802,38 @@ void MitochondriaSolver::run()
           writeOutput(step,time);
         }
 
-      if (step == 0 ) 
+      //(re)built at the start and whenever rebalancing changed the grids
+      if (m_integrator.size() == 0)
         {
           m_integrator.resize(m_volumes.size());
           for (int ivol = 0; ivol < m_volumes.size(); ivol++)
             {
-              m_integrator[ivol].resize(m_params.m_ncomp);
-              for (int ivar = 0; ivar <  m_params.m_ncomp; ivar++)
+              if (m_params.m_blockSolve)
+                {
+                  m_integrator[ivol].resize(1);
+                  defineSolver(m_integrator[ivol][0], ivol, 0, m_params.m_ncomp);
+                }
+              else
                 {
-                  defineSolver(m_integrator[ivol][ivar], ivol, ivar);
+                  m_integrator[ivol].resize(m_params.m_ncomp);
+                  for (int ivar = 0; ivar <  m_params.m_ncomp; ivar++)
+                    {
+                      defineSolver(m_integrator[ivol][ivar], ivol, ivar);
+                    }
                 }
             }
         }
       //advance the solution
-      for (int ivar = 0; ivar < m_params.m_ncomp; ivar++)
+      if (m_params.m_blockSolve)
         {
-          advanceOneVariable(ivar);
+          advanceAllVariables();
+        }
+      else
+        {
+          for (int ivar = 0; ivar < m_params.m_ncomp; ivar++)
+            {
+              advanceOneVariable(ivar);
+            }
         }
 
       // Copy the new solution to the old solution
@@ -627,6 +842,12 @@ void MitochondriaSolver::run()
           CH_TIME("MitochondriaSolver::copy");
           EBAMRDataOps::assign(m_solnOld[ivol],m_solnNew[ivol]);
         }
+
+      if ((m_params.m_loadBalanceInterval > 0) &&
+          ((step+1) % m_params.m_loadBalanceInterval == 0))
+        {
+          rebalance();
+        }
     }
 
   // Write the solution at the end
@@ -634,6 +855,9 @@ void MitochondriaSolver::run()
     {
       writeOutput(step,m_params.m_endTime);
     }
+
+  // Make sure everything is on disk (this also stops the writer thread)
+  setEBHDF5Async(false);
 }
 
 void MitochondriaSolver::getDiffusionConstants()
@@ -658,12 +882,29 @@ void MitochondriaSolver::initGeometry()
       fineDx /= m_params.m_refRatio[ilev];
     }
 
-  // Create the implicit function for one of the known geometries
-  BaseIF* geometry;
-  MFIndexSpace mfIndexSpace;
+  // Reuse a stored index space for this geometry if there is one
+  bool useCache = (m_params.m_ebisCacheDir.size() > 0);
+  unsigned long long geomHash = 0;
+  if (useCache)
+    {
+      MitochondriaIF1 phase0;
+      geomHash = geometryHash(phase0, fineDomain.domainBox(), m_params.m_loCorner,
+                              fineDx[0], m_params.m_numLevels);
+    }
+
+  if (!useCache || !readCachedComponents(m_volumes, m_params.m_ebisCacheDir, geomHash, fineDomain))
+    {
+      // Create the implicit function for one of the known geometries
+      BaseIF* geometry;
+      MFIndexSpace mfIndexSpace;
 
-  geometry = makeMitochondriaGeometry(mfIndexSpace, fineDomain.domainBox(), m_params.m_loCorner, fineDx[0]);
-  getConnectedComponents(m_volumes, mfIndexSpace);
+      geometry = makeMitochondriaGeometry(mfIndexSpace, fineDomain.domainBox(), m_params.m_loCorner, fineDx[0]);
+      getConnectedComponents(m_volumes, mfIndexSpace);
+      if (useCache)
+        {
+          writeCachedComponents(m_volumes, m_params.m_ebisCacheDir, geomHash);
+        }
+    }
   pout() << "m_volumes.size(): " << m_volumes.size() << endl;
 
   getDiffusionConstants();
@@ -910,6 +1151,9 @@ void MitochondriaSolver::initIndexSpace()
         }
     }  
 
+  //grids have changed so cached level grids and interpolators are stale
+  m_eblgCache.resize(0);
+
   if (pp.contains("abr_file_output_name"))
     {
       string abrFile;
@@ -936,46 +1180,62 @@ void MitochondriaSolver::getEBLGAndQuadCFI(Vector<EBLevelGrid>
                                           int                                     a_ivol,
                                           int                                     a_ncomp)
 {
-  a_ebLevelGrids.resize(m_grids.size());
-  a_quadCFInterp.resize(m_grids.size());
-
-  // Define the data holders and interpolators
-  ProblemDomain levelDomain = m_params.m_coarsestDomain;
-  ProblemDomain coarserDomain;
-  for (int ilev = 0; ilev < m_grids.size(); ilev++)
+  CH_TIME("MitochondriaSolver::getEBLGAndQuadCFI");
+  //these only depend on the grids so they are built once and reused
+  //until the grids change
+  if (m_eblgCache.size() != m_volumes.size())
     {
-      a_ebLevelGrids[ilev].define(m_grids[ilev],m_ebisl[a_ivol][ilev],levelDomain);
-
-      if (ilev > 0)
-        {
-          int numVariables = a_ncomp;
-
-          a_quadCFInterp[ilev] = RefCountedPtr<EBQuadCFInterp>
-            (new EBQuadCFInterp(m_grids[ilev],
-                                m_grids[ilev-1],
-                                m_ebisl[a_ivol][ilev],
-                                m_ebisl[a_ivol][ilev-1],
-                                coarserDomain,
-                                m_params.m_refRatio[ilev-1],
-                                numVariables,
-                                *(a_ebLevelGrids[ilev].getCFIVS()),
-                                &(*m_volumes[a_ivol])));
-        }
-
-      coarserDomain = levelDomain;
-
-      if (ilev < m_grids.size()-1)
-        {
-          levelDomain.refine(m_params.m_refRatio[ilev]);
-        }
+      m_eblgCache.resize(m_volumes.size());
+    }
+  if (m_eblgCache[a_ivol].isNull())
+    {
+      m_eblgCache[a_ivol] = RefCountedPtr<EBLevelGridCache>(new EBLevelGridCache());
     }
+  EBLevelGridCache& cache = *m_eblgCache[a_ivol];
+  if (!cache.isCurrent(m_grids, m_ebisl[a_ivol], &(*m_volumes[a_ivol])))
+    {
+      cache.define(m_grids,
+                   m_ebisl[a_ivol],
+                   m_params.m_coarsestDomain,
+                   m_params.m_refRatio,
+                   &(*m_volumes[a_ivol]));
+    }
+
+  a_ebLevelGrids = cache.getEBLevelGrids();
+  a_quadCFInterp = cache.getQuadCFInterp(a_ncomp);
 }
 
 
 
+/// Dirichlet value that is a different constant for each component
+class ComponentConstantBCValue: public BaseBCValue
+{
+public:
+  ComponentConstantBCValue(const Vector<Real>& a_values)
+    : m_values(a_values)
+  {
+  }
+
+  virtual ~ComponentConstantBCValue()
+  {
+  }
+
+  virtual Real value(const RealVect& a_point,
+                     const RealVect& a_normal,
+                     const Real&     a_time,
+                     const int&      a_comp) const
+  {
+    return m_values[a_comp];
+  }
+
+protected:
+  Vector<Real> m_values;
+};
+
 void MitochondriaSolver::getConstantCoeffOpFactory(RefCountedPtr<EBAMRPoissonOpFactory>& a_factory,
                                                   int                                   a_ivol,
-                                                  int                                   a_ivar)
+                                                  int                                   a_ivar,
+                                                  int                                   a_ncomp)
 {
   // Set up the no flux domain and embedded boundary conditions
   //RefCountedPtr<NeumannPoissonDomainBCFactory> domBC(new NeumannPoissonDomainBCFactory());
@@ -984,19 +1244,25 @@ void MitochondriaSolver::getConstantCoeffOpFactory(RefCountedPtr<EBAMRPoissonOpF
   RefCountedPtr<DirichletPoissonDomainBCFactory> domBC(new DirichletPoissonDomainBCFactory());
   //RefCountedPtr<DirichletPoissonEBBCFactory>      ebBC(new DirichletPoissonEBBCFactory());
   //ebBC->setOrder(1);
-  if(a_ivol == m_params.m_ivol_mat)
+  const Vector<Real>& initialValue = (a_ivol == m_params.m_ivol_mat) ? m_params.m_initialValueMat : m_params.m_initialValueCyt;
+  if (a_ncomp == 1)
     {
-      domBC->setValue(m_params.m_initialValueMat[a_ivar]);
+      domBC->setValue(initialValue[a_ivar]);
     }
   else
     {
-      domBC->setValue(m_params.m_initialValueCyt[a_ivar]);
+      Vector<Real> values(a_ncomp);
+      for (int icomp = 0; icomp < a_ncomp; icomp++)
+        {
+          values[icomp] = initialValue[a_ivar + icomp];
+        }
+      domBC->setFunction(RefCountedPtr<BaseBCValue>(new ComponentConstantBCValue(values)));
     }
   ebBC->setValue(0.);
 
   Vector<EBLevelGrid>  eblg;
   Vector<RefCountedPtr<EBQuadCFInterp> > quadCFI;
-  getEBLGAndQuadCFI(eblg, quadCFI, a_ivol);
+  getEBLGAndQuadCFI(eblg, quadCFI, a_ivol, a_ncomp);
 
   //coefficients come in through the =coefficients.
   //  pout() << "using multicolored gauss seidel" << endl;
@@ -1022,8 +1288,21 @@ void MitochondriaSolver::getConstantCoeffOpFactory(RefCountedPtr<EBAMRPoissonOpF
                                domBC, ebBC, alpha, m_diffusionConstants[a_ivol], m_time,
                                m_params.m_numGhostSoln, m_params.m_numGhostSource));
 
-  a_factory->setData(m_scalBou[a_ivol]);
+  if (a_ncomp == 1)
+    {
+      a_factory->setData(m_scalBou[a_ivol]);
+    }
+  else
+    {
+      CH_assert(a_ivar == 0);
+      a_factory->setNumComps(a_ncomp);
+      a_factory->setData(m_bounVal[a_ivol]);
+    }
 
+  if (m_params.m_loadBalanceInterval > 0)
+    {
+      a_factory->setBoxCosts(m_boxCosts);
+    }
 }
 
 
@@ -1045,53 +1324,12 @@ void MitochondriaSolver::initData()
       pout() << "initial value mat for variable " << ivar << " =  " << m_params.m_initialValueMat[ivar] << endl;
     }
 
-  // Make pointers for data holders at each AMR level
-
-  m_solnOld.resize(m_volumes.size());
-  m_solnNew.resize(m_volumes.size());
-  m_soursin.resize(m_volumes.size());
-  m_bounVal.resize(m_volumes.size());
-  m_dataBou.resize(m_volumes.size());
-  m_scalBou.resize(m_volumes.size());
-  m_scalOld.resize(m_volumes.size());
-  m_scalNew.resize(m_volumes.size());
-  m_scalRHS.resize(m_volumes.size());
-  m_irrSets.resize(m_volumes.size());
+  allocateData();
 
   for (int ivol = 0; ivol < m_volumes.size(); ivol++)
     {
-      m_solnOld[ivol].resize(m_params.m_numLevels);
-      m_solnNew[ivol].resize(m_params.m_numLevels);
-      m_soursin[ivol].resize(m_params.m_numLevels);
-      m_bounVal[ivol].resize(m_params.m_numLevels);
-      m_dataBou[ivol].resize(m_params.m_numLevels);
-      m_scalBou[ivol].resize(m_params.m_numLevels);
-      m_scalOld[ivol].resize(m_params.m_numLevels);
-      m_scalNew[ivol].resize(m_params.m_numLevels);
-      m_scalRHS[ivol].resize(m_params.m_numLevels);
-      m_irrSets[ivol].resize(m_params.m_numLevels);
-
       for (int ilev = 0; ilev < m_params.m_numLevels; ilev++)
         {
-          m_irrSets[ivol][ilev] = RefCountedPtr<LayoutData<IntVectSet> >(new LayoutData<IntVectSet>(m_grids[ilev]));
-          for (DataIterator dit = m_grids[ilev].dataIterator(); dit.ok(); ++dit)
-            {
-              (*m_irrSets[ivol][ilev])[dit()] = m_ebisl[ivol][ilev][dit()].getIrregIVS(m_grids[ilev][dit()]);
-            }
-
-          // At each level, allocate and initialize (as needed) space for the old
-          // solution, the new solution, and the source/sink terms
-          EBCellFactory        ebCellFactory(m_ebisl[ivol][ilev]);
-          BaseIVFactory<Real>  bivfabFactory(m_ebisl[ivol][ilev], *m_irrSets[ivol][ilev]);
-          m_dataBou[ivol][ilev] = RefCountedPtr<LevelData< BaseIVFAB<Real> > >(new LevelData< BaseIVFAB<Real> >(m_grids[ilev], m_params.m_ncomp, IntVect::Zero, bivfabFactory));
-          m_bounVal[ivol][ilev] = RefCountedPtr<LevelData< BaseIVFAB<Real> > >(new LevelData< BaseIVFAB<Real> >(m_grids[ilev], m_params.m_ncomp, IntVect::Zero, bivfabFactory));
-          m_scalBou[ivol][ilev] = RefCountedPtr<LevelData< BaseIVFAB<Real> > >(new LevelData< BaseIVFAB<Real> >(m_grids[ilev],                1, IntVect::Zero, bivfabFactory));
-          m_solnOld[ivol][ilev] = new LevelData<EBCellFAB>(m_grids[ilev], m_params.m_ncomp, m_params.m_numGhostSoln,   ebCellFactory);
-          m_solnNew[ivol][ilev] = new LevelData<EBCellFAB>(m_grids[ilev], m_params.m_ncomp, m_params.m_numGhostSoln,   ebCellFactory);
-          m_soursin[ivol][ilev] = new LevelData<EBCellFAB>(m_grids[ilev], m_params.m_ncomp, m_params.m_numGhostSource, ebCellFactory);
-          m_scalOld[ivol][ilev] = new LevelData<EBCellFAB>(m_grids[ilev],                1, m_params.m_numGhostSoln,   ebCellFactory);
-          m_scalNew[ivol][ilev] = new LevelData<EBCellFAB>(m_grids[ilev],                1, m_params.m_numGhostSoln,   ebCellFactory);
-          m_scalRHS[ivol][ilev] = new LevelData<EBCellFAB>(m_grids[ilev],                1, m_params.m_numGhostSource, ebCellFactory);
           if(ivol == m_params.m_ivol_mat)
             {
               for(int ivar = 0; ivar < m_params.m_ncomp; ivar++)
@@ -1169,6 +1407,160 @@ void MitochondriaSolver::initData()
           pout().precision(origPrecision);
         } //end loop over levels
     } //end loop over volumes
+
+  //which irregular vofs face which other volumes only changes with the grids
+  definePairing();
+}
+
+void MitochondriaSolver::allocateData()
+{
+  CH_TIME("MitochondriaSolver::allocateData");
+
+  // Make pointers for data holders at each AMR level
+
+  m_solnOld.resize(m_volumes.size());
+  m_solnNew.resize(m_volumes.size());
+  m_soursin.resize(m_volumes.size());
+  m_bounVal.resize(m_volumes.size());
+  m_dataBou.resize(m_volumes.size());
+  m_scalBou.resize(m_volumes.size());
+  m_scalOld.resize(m_volumes.size());
+  m_scalNew.resize(m_volumes.size());
+  m_scalRHS.resize(m_volumes.size());
+  m_irrSets.resize(m_volumes.size());
+
+  for (int ivol = 0; ivol < m_volumes.size(); ivol++)
+    {
+      m_solnOld[ivol].resize(m_params.m_numLevels);
+      m_solnNew[ivol].resize(m_params.m_numLevels);
+      m_soursin[ivol].resize(m_params.m_numLevels);
+      m_bounVal[ivol].resize(m_params.m_numLevels);
+      m_dataBou[ivol].resize(m_params.m_numLevels);
+      m_scalBou[ivol].resize(m_params.m_numLevels);
+      m_scalOld[ivol].resize(m_params.m_numLevels);
+      m_scalNew[ivol].resize(m_params.m_numLevels);
+      m_scalRHS[ivol].resize(m_params.m_numLevels);
+      m_irrSets[ivol].resize(m_params.m_numLevels);
+
+      for (int ilev = 0; ilev < m_params.m_numLevels; ilev++)
+        {
+          m_irrSets[ivol][ilev] = RefCountedPtr<LayoutData<IntVectSet> >(new LayoutData<IntVectSet>(m_grids[ilev]));
+          for (DataIterator dit = m_grids[ilev].dataIterator(); dit.ok(); ++dit)
+            {
+              (*m_irrSets[ivol][ilev])[dit()] = m_ebisl[ivol][ilev][dit()].getIrregIVS(m_grids[ilev][dit()]);
+            }
+
+          // At each level, allocate and initialize (as needed) space for the old
+          // solution, the new solution, and the source/sink terms
+          EBCellFactory        ebCellFactory(m_ebisl[ivol][ilev]);
+          BaseIVFactory<Real>  bivfabFactory(m_ebisl[ivol][ilev], *m_irrSets[ivol][ilev]);
+          m_dataBou[ivol][ilev] = RefCountedPtr<LevelData< BaseIVFAB<Real> > >(new LevelData< BaseIVFAB<Real> >(m_grids[ilev], m_params.m_ncomp, IntVect::Zero, bivfabFactory));
+          m_bounVal[ivol][ilev] = RefCountedPtr<LevelData< BaseIVFAB<Real> > >(new LevelData< BaseIVFAB<Real> >(m_grids[ilev], m_params.m_ncomp, IntVect::Zero, bivfabFactory));
+          m_solnOld[ivol][ilev] = new LevelData<EBCellFAB>(m_grids[ilev], m_params.m_ncomp, m_params.m_numGhostSoln,   ebCellFactory);
+          m_solnNew[ivol][ilev] = new LevelData<EBCellFAB>(m_grids[ilev], m_params.m_ncomp, m_params.m_numGhostSoln,   ebCellFactory);
+          m_soursin[ivol][ilev] = new LevelData<EBCellFAB>(m_grids[ilev], m_params.m_ncomp, m_params.m_numGhostSource, ebCellFactory);
+          //scalar scratch space is only needed when the variables are solved one at a time
+          if (!m_params.m_blockSolve)
+            {
+              m_scalBou[ivol][ilev] = RefCountedPtr<LevelData< BaseIVFAB<Real> > >(new LevelData< BaseIVFAB<Real> >(m_grids[ilev],                1, IntVect::Zero, bivfabFactory));
+              m_scalOld[ivol][ilev] = new LevelData<EBCellFAB>(m_grids[ilev],                1, m_params.m_numGhostSoln,   ebCellFactory);
+              m_scalNew[ivol][ilev] = new LevelData<EBCellFAB>(m_grids[ilev],                1, m_params.m_numGhostSoln,   ebCellFactory);
+              m_scalRHS[ivol][ilev] = new LevelData<EBCellFAB>(m_grids[ilev],                1, m_params.m_numGhostSource, ebCellFactory);
+            }
+        }
+    }
+
+  //costs are measured on the grids the data lives on
+  if (m_params.m_loadBalanceInterval > 0)
+    {
+      m_boxCosts.resize(m_params.m_numLevels);
+      for (int ilev = 0; ilev < m_params.m_numLevels; ilev++)
+        {
+          m_boxCosts[ilev] = RefCountedPtr<EBMeasuredLoads>(new EBMeasuredLoads(m_grids[ilev]));
+        }
+    }
+}
+
+void MitochondriaSolver::rebalance()
+{
+  CH_TIME("MitochondriaSolver::rebalance");
+
+  //the same boxes, handed out on what they actually cost since the last look
+  bool gridsChanged = false;
+  for (int ilev = 0; ilev < m_params.m_numLevels; ilev++)
+    {
+      EBMeasuredLoads& costs = *m_boxCosts[ilev];
+      costs.merge();
+      Real imbalance = costs.imbalance();
+      pout() << "level " << ilev << ": measured load imbalance = " << imbalance << endl;
+      if (imbalance <= m_params.m_loadBalanceThreshold)
+        {
+          continue;
+        }
+
+      Vector<int> procs;
+      costs.newProcs(procs);
+      if (procs.stdVector() == m_grids[ilev].procIDs().stdVector())
+        {
+          continue;
+        }
+
+      ProblemDomain domain = m_grids[ilev].physDomain();
+      m_grids[ilev] = DisjointBoxLayout(m_grids[ilev].boxArray(), procs, domain);
+      for (int ivol = 0; ivol < m_volumes.size(); ivol++)
+        {
+          m_volumes[ivol]->fillEBISLayout(m_ebisl[ivol][ilev],
+                                          m_grids[ilev],
+                                          domain,
+                                          m_params.m_numGhostEBISLayout);
+        }
+      gridsChanged = true;
+    }
+
+  if (!gridsChanged)
+    {
+      for (int ilev = 0; ilev < m_params.m_numLevels; ilev++)
+        {
+          m_boxCosts[ilev]->clear();
+        }
+      return;
+    }
+  pout() << "rebalancing grids on measured costs" << endl;
+
+  //move the solution over to the new layouts.   everything else is
+  //either recomputed every step (source, boundary data) or scratch.
+  Vector< Vector<LevelData<EBCellFAB>* > > oldSolnOld = m_solnOld;
+  Vector< Vector<LevelData<EBCellFAB>* > > oldSolnNew = m_solnNew;
+  for (int ivol = 0; ivol < m_volumes.size(); ivol++)
+    {
+      for (int ilev = 0; ilev < m_params.m_numLevels; ilev++)
+        {
+          delete m_scalOld[ivol][ilev];
+          delete m_scalNew[ivol][ilev];
+          delete m_scalRHS[ivol][ilev];
+          delete m_soursin[ivol][ilev];
+          delete m_extrStn[ivol][ilev];
+        }
+    }
+
+  allocateData();
+
+  for (int ivol = 0; ivol < m_volumes.size(); ivol++)
+    {
+      for (int ilev = 0; ilev < m_params.m_numLevels; ilev++)
+        {
+          oldSolnOld[ivol][ilev]->copyTo(*m_solnOld[ivol][ilev]);
+          oldSolnNew[ivol][ilev]->copyTo(*m_solnNew[ivol][ilev]);
+          delete oldSolnOld[ivol][ilev];
+          delete oldSolnNew[ivol][ilev];
+        }
+    }
+
+  //everything built on the old grids has to go
+  m_eblgCache.resize(0);
+  definePairing();
+  initStencils();
+  m_integrator.resize(0);
 }
 
 void MitochondriaSolver::setSource()
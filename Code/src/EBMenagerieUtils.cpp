@@ -9,6 +9,10 @@
 #endif
 
 #include <stdio.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fstream>
 
 #include "BoxIterator.H"
 #include "ParmParse.H"
@@ -23,6 +27,8 @@
 #include "EBCellFactory.H"
 #include "PolyGeom.H"
 #include "EBAMRIO.H"
+#include "SPMD.H"
+#include "CH_HDF5.H"
 
 #include "PlaneIF.H"
 #include "SphereIF.H"
@@ -76,10 +82,7 @@ void getDomainOriginDx(Box      & a_domain,
   }
 }
 
-BaseIF* makeMultiSphereGeometry(MFIndexSpace   & a_mfIndexSpace,
-                                const Box      & a_domain,
-                                const RealVect & a_origin,
-                                const Real     & a_dx)
+BaseIF* makeMultiSphereIF()
 {
   // parse input file
   ParmParse pp;
@@ -179,8 +182,31 @@ BaseIF* makeMultiSphereGeometry(MFIndexSpace   & a_mfIndexSpace,
     }
   }
 
-  RefCountedPtr<BaseIF> everythingPhase0( new UnionIF(unionList));
+  // the union makes its own copies
+  BaseIF* everything = new UnionIF(unionList);
 
+  for (int i = 0; i < numIntersectionLists; i++)
+  {
+    delete unionList[i];
+  }
+
+  for (int i = 0; i < numSpheres; i++)
+  {
+    delete spheres[i];
+  }
+
+  return everything;
+}
+
+BaseIF* makeMultiSphereGeometry(MFIndexSpace   & a_mfIndexSpace,
+                                const Box      & a_domain,
+                                const RealVect & a_origin,
+                                const Real     & a_dx)
+{
+  // parse input file
+  ParmParse pp;
+
+  RefCountedPtr<BaseIF> everythingPhase0(makeMultiSphereIF());
 
   // Complement for MF
   bool complement = true;
@@ -232,16 +258,6 @@ BaseIF* makeMultiSphereGeometry(MFIndexSpace   & a_mfIndexSpace,
   // This generates the new EBIS
   a_mfIndexSpace.define(a_domain,a_origin,a_dx,geometries,maxBoxSize/* ,maxCoarsenings */);
 
-  for (int i = 0; i < numIntersectionLists; i++)
-  {
-    delete unionList[i];
-  }
-
-  for (int i = 0; i < numSpheres; i++)
-  {
-    delete spheres[i];
-  }
-
   BaseIF* retval =  everythingPhase0->newImplicitFunction();
   delete geometries[0];
   delete geometries[1];
@@ -1073,3 +1089,212 @@ void createEBDistributionFiles()
   }
 #endif
 }
+
+// FNV-1a, which is all a cache key needs
+static void hashBytes(unsigned long long & a_hash,
+                      const void         * a_bytes,
+                      size_t               a_numBytes)
+{
+  const unsigned char* bytes = (const unsigned char*)a_bytes;
+  for (size_t i = 0; i < a_numBytes; i++)
+  {
+    a_hash ^= bytes[i];
+    a_hash *= 1099511628211ULL;
+  }
+}
+
+static std::string cacheName(const std::string        & a_cacheDir,
+                             const unsigned long long & a_hash,
+                             const int                & a_comp)
+{
+  char name[64];
+  if (a_comp < 0)
+  {
+    sprintf(name, "/ebis_%016llx.txt", a_hash);
+  }
+  else
+  {
+    sprintf(name, "/ebis_%016llx_%d.hdf5", a_hash, a_comp);
+  }
+  return a_cacheDir + std::string(name);
+}
+
+// Name to write a cache file under before it is renamed into place, so
+// that another job never reads a partly written file.
+static std::string tempCacheName(const std::string & a_name,
+                                 const int         & a_pid)
+{
+  char suffix[32];
+  sprintf(suffix, ".tmp%d", a_pid);
+  return a_name + std::string(suffix);
+}
+
+unsigned long long geometryHash(const BaseIF   & a_phase0,
+                                const Box      & a_fineDomain,
+                                const RealVect & a_origin,
+                                const Real     & a_fineDx,
+                                const int      & a_numLevels)
+{
+  CH_TIME("geometryHash");
+  ParmParse pp;
+
+  // bump this if the cache file layout changes
+  const int cacheVersion = 1;
+
+  unsigned long long hash = 14695981039346656037ULL;
+  hashBytes(hash, &cacheVersion, sizeof(int));
+  int dim = SpaceDim;
+  hashBytes(hash, &dim, sizeof(int));
+  hashBytes(hash, a_fineDomain.smallEnd().getVect(), SpaceDim*sizeof(int));
+  hashBytes(hash, a_fineDomain.bigEnd().getVect(),   SpaceDim*sizeof(int));
+  hashBytes(hash, a_origin.dataPtr(), SpaceDim*sizeof(Real));
+  hashBytes(hash, &a_fineDx,    sizeof(Real));
+  hashBytes(hash, &a_numLevels, sizeof(int));
+
+  // same defaults as the make*Geometry functions
+  bool useNewGeometry = true;
+  pp.query("use_new_geometry_gen", useNewGeometry);
+  int newGeometry = useNewGeometry ? 1 : 0;
+  Real threshold = sqrt(2.);
+  pp.query("ba_threshold", threshold);
+  int maxBoxSize;
+  pp.get("maxboxsize", maxBoxSize);
+  hashBytes(hash, &newGeometry,    sizeof(int));
+  hashBytes(hash, &threshold,      sizeof(Real));
+  hashBytes(hash, &maxBoxSize,     sizeof(int));
+
+  std::string tag;
+  pp.query("ebis_cache_tag", tag);
+  hashBytes(hash, tag.c_str(), tag.size());
+
+  // Sample the implicit function.  The lattice is offset from the cell
+  // centers so that it does not line up with planes and sphere centers
+  // placed at "nice" coordinates.
+  int numSamples = 32;
+  pp.query("ebis_cache_samples", numSamples);
+  CH_assert(numSamples > 0);
+  Box sampleBox(IntVect::Zero, (numSamples-1)*IntVect::Unit);
+  RealVect extent;
+  for (int idir = 0; idir < SpaceDim; idir++)
+  {
+    extent[idir] = a_fineDx*a_fineDomain.size(idir);
+  }
+  Vector<RealVect> points(sampleBox.numPts());
+  int ipt = 0;
+  for (BoxIterator bit(sampleBox); bit.ok(); ++bit, ++ipt)
+  {
+    for (int idir = 0; idir < SpaceDim; idir++)
+    {
+      Real frac = (bit()[idir] + 0.381966)/numSamples;
+      points[ipt][idir] = a_origin[idir] + frac*extent[idir];
+    }
+  }
+  Vector<Real> values(points.size());
+  a_phase0.value(&(points[0]), &(values[0]), points.size());
+  hashBytes(hash, &(values[0]), values.size()*sizeof(Real));
+
+  return hash;
+}
+
+bool readCachedComponents(Vector<RefCountedPtr<EBIndexSpace> > & a_allComponents,
+                          const std::string                    & a_cacheDir,
+                          const unsigned long long             & a_hash,
+                          const ProblemDomain                  & a_fineDomain)
+{
+#ifdef CH_USE_HDF5
+  CH_TIME("readCachedComponents");
+
+  // the index file is written last, so it marks a complete entry
+  int numComps = -1;
+  if (procID() == uniqueProc(SerialTask::compute))
+  {
+    std::ifstream index(cacheName(a_cacheDir, a_hash, -1).c_str());
+    if (!(index >> numComps))
+    {
+      numComps = -1;
+    }
+  }
+  broadcast(numComps, uniqueProc(SerialTask::compute));
+  if (numComps < 0)
+  {
+    return false;
+  }
+
+  pout() << "reading " << numComps << " cached EBIS components from " << a_cacheDir << endl;
+  Vector<RefCountedPtr<EBIndexSpace> > components(numComps);
+  for (int icomp = 0; icomp < numComps; icomp++)
+  {
+    HDF5Handle handle(cacheName(a_cacheDir, a_hash, icomp), HDF5Handle::OPEN_RDONLY);
+    components[icomp] = RefCountedPtr<EBIndexSpace>(new EBIndexSpace());
+    components[icomp]->readInAllLevels(handle, a_fineDomain);
+    handle.close();
+  }
+  a_allComponents.append(components);
+  return true;
+#else
+  return false;
+#endif
+}
+
+void writeCachedComponents(const Vector<RefCountedPtr<EBIndexSpace> > & a_allComponents,
+                           const std::string                          & a_cacheDir,
+                           const unsigned long long                   & a_hash)
+{
+#ifdef CH_USE_HDF5
+  CH_TIME("writeCachedComponents");
+  const int root = uniqueProc(SerialTask::compute);
+  if (procID() == root)
+  {
+    if ((mkdir(a_cacheDir.c_str(), 0755) != 0) && (errno != EEXIST))
+    {
+      pout() << "could not create EBIS cache directory " << a_cacheDir << endl;
+    }
+  }
+  // every processor writes the same temporary files, named by the root's pid
+  int pid = getpid();
+  broadcast(pid, root);
+
+  for (int icomp = 0; icomp < a_allComponents.size(); icomp++)
+  {
+    HDF5Handle handle(tempCacheName(cacheName(a_cacheDir, a_hash, icomp), pid),
+                      HDF5Handle::CREATE);
+    a_allComponents[icomp]->writeAllLevels(handle);
+    handle.close();
+  }
+  barrier();
+
+  // rename is atomic, and the index goes last so that a reader that
+  // finds it finds every component file complete
+  if (procID() == root)
+  {
+    bool renamed = true;
+    for (int icomp = 0; icomp < a_allComponents.size(); icomp++)
+    {
+      std::string name = cacheName(a_cacheDir, a_hash, icomp);
+      if (rename(tempCacheName(name, pid).c_str(), name.c_str()) != 0)
+      {
+        renamed = false;
+      }
+    }
+
+    std::string indexName = cacheName(a_cacheDir, a_hash, -1);
+    if (renamed)
+    {
+      {
+        std::ofstream index(tempCacheName(indexName, pid).c_str());
+        index << a_allComponents.size() << endl;
+      }
+      if (rename(tempCacheName(indexName, pid).c_str(), indexName.c_str()) != 0)
+      {
+        renamed = false;
+      }
+    }
+    if (!renamed)
+    {
+      pout() << "could not store EBIS components in " << a_cacheDir << endl;
+    }
+  }
+  barrier();
+  pout() << "stored " << a_allComponents.size() << " EBIS components in " << a_cacheDir << endl;
+#endif
+}
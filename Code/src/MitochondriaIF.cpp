@@ -226,6 +226,23 @@ Real MitochondriaIF1::value(const RealVect & a_point) const
   return final;
 }
 
+//same as value() above but with the dimple evaluated over all the points at once
+void MitochondriaIF1::value(const RealVect* a_points,
+                            Real*           a_values,
+                            int             a_npts) const
+{
+  m_dimple->value(a_points, a_values, a_npts);
+
+  Real r3 = 0.9;
+  for (int ipt = 0; ipt < a_npts; ipt++)
+    {
+      const RealVect& point = a_points[ipt];
+      Real sphere = D_TERM(point[0]*point[0], + point[1]*point[1], + point[2]*point[2]) - r3*r3;
+
+      a_values[ipt] = Max(sphere,-a_values[ipt]);
+    }
+}
+
 BaseIF* MitochondriaIF1::newImplicitFunction() const
 {
   return new MitochondriaIF1();
@@ -185,6 +185,7 @@ CFIVS::packIVS()
           ++s_sparseCount;
 #endif
           m_packed = false;
+          m_IVS.compress();
         }
     }
 }
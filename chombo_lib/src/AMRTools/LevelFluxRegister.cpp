@@ -656,6 +656,35 @@ void LevelFluxRegister::reflux(
   if (m_noRealCoarseFineInterface)
     return;
   CH_TIME("LevelFluxRegister::reflux");
+  refluxBegin(a_uCoarse, a_coarse_interval, a_flux_interval, a_scale);
+  refluxEnd(a_uCoarse, a_coarse_interval, a_flux_interval, a_scale);
+}
+
+void LevelFluxRegister::refluxBegin(
+                                    LevelData<FArrayBox>& a_uCoarse,
+                                    const Interval&       a_coarse_interval,
+                                    const Interval&       a_flux_interval,
+                                    Real                  a_scale )
+{
+  CH_assert(isDefined() );
+  if (m_noRealCoarseFineInterface)
+    return;
+  CH_TIME("LevelFluxRegister::refluxBegin");
+  AddOp op;
+  op.scale = -a_scale;
+  m_fineFlux.copyToBegin(a_flux_interval, a_uCoarse, a_coarse_interval, m_reverseCopier, op);
+}
+
+void LevelFluxRegister::refluxEnd(
+                                  LevelData<FArrayBox>& a_uCoarse,
+                                  const Interval&       a_coarse_interval,
+                                  const Interval&       a_flux_interval,
+                                  Real                  a_scale )
+{
+  CH_assert(isDefined() );
+  if (m_noRealCoarseFineInterface)
+    return;
+  CH_TIME("LevelFluxRegister::refluxEnd");
   for (DataIterator dit(a_uCoarse.dataIterator()); dit.ok(); ++dit)
     {
       FArrayBox& u = a_uCoarse[dit];
@@ -665,8 +694,7 @@ void LevelFluxRegister::reflux(
     }
   AddOp op;
   op.scale = -a_scale;
-  m_fineFlux.copyTo(a_flux_interval, a_uCoarse, a_coarse_interval, m_reverseCopier, op);
-
+  m_fineFlux.copyToEnd(a_flux_interval, a_uCoarse, a_coarse_interval, m_reverseCopier, op);
 }
 
 void LevelFluxRegister::reflux(
@@ -181,6 +181,74 @@ bool BitSet::isEmpty() const
   return true;
 }
 
+// number of set bits in a word
+static inline int bitSetPopCount(BITSETWORD a_word)
+{
+#ifdef __GNUC__
+  return __builtin_popcount(a_word);
+#else
+  int count = 0;
+  for (; a_word != 0; a_word &= a_word - 1) ++count;
+  return count;
+#endif
+}
+
+// position of the first set bit counting from the most significant one,
+// which is bit 0 in BitSet's convention (see trueMasks).  a_word != 0.
+static inline int bitSetLeadingZeros(BITSETWORD a_word)
+{
+#ifdef __GNUC__
+  return __builtin_clz(a_word);
+#else
+  int n = 0;
+  BITSETWORD top = ((BITSETWORD)1) << (BITSETWORDSIZE-1);
+  for (; !(a_word & top); a_word <<= 1) ++n;
+  return n;
+#endif
+}
+
+int BitSet::countTrue(int a_begin, int a_length, int* a_histogram) const
+{
+  CH_assert(a_begin >= 0);
+  CH_assert(a_length >= 0);
+  CH_assert(a_begin + a_length <= m_size);
+
+  const BITSETWORD allOnes = ~((BITSETWORD)0);
+  int count = 0;
+  int pos = a_begin;
+  int end = a_begin + a_length;
+  while (pos < end)
+    {
+      int index = pos/BITSETWORDSIZE;
+      int first = pos - BITSETWORDSIZE*index;
+      int last  = first + (end - pos);
+      if (last > BITSETWORDSIZE) last = BITSETWORDSIZE;
+
+      // bit 0 is the high bit, so mask off the high 'first' bits and
+      // everything from 'last' down
+      BITSETWORD word = m_bits[index];
+      if (first > 0)              word &= allOnes >> first;
+      if (last < BITSETWORDSIZE)  word &= ~(allOnes >> last);
+
+      if (word != 0)
+        {
+          count += bitSetPopCount(word);
+          if (a_histogram != NULL)
+            {
+              int offset = BITSETWORDSIZE*index - a_begin;
+              while (word != 0)
+                {
+                  int bit = bitSetLeadingZeros(word);
+                  a_histogram[offset + bit]++;
+                  word &= ~trueMasks[bit];
+                }
+            }
+        }
+      pos += last - first;
+    }
+  return count;
+}
+
 bool BitSet::isFull() const
 {
   BITSETWORD g=0;
@@ -8,12 +8,34 @@
  */
 #endif
 
+#include <pthread.h>
 #include "CH_Thread.H"
 #include "NamespaceHeader.H"
 
+static bool      s_haveHelper = false;
+static pthread_t s_helperThread;
+
+void setHelperThread(bool a_isHelper)
+{
+  if (a_isHelper)
+    {
+      s_helperThread = pthread_self();
+    }
+  s_haveHelper = a_isHelper;
+}
+
+bool onHelperThread()
+{
+  return (s_haveHelper && pthread_equal(pthread_self(), s_helperThread));
+}
+
 bool onThread0()
 {
   bool retval = true;
+  if (onHelperThread())
+    {
+      return false;
+    }
 #ifdef _OPENMP
   int thread_num = omp_get_thread_num();
   retval = (thread_num== 0);
@@ -11,6 +11,7 @@
 #ifndef CH_NTIMER
 
 #include "CH_Timer.H"
+#include "CH_Thread.H"
 
 #include <iostream>
 #include "memtrack.H"
@@ -22,6 +23,7 @@
 #include "CH_assert.H"
 #include "parstream.H"
 #include <cstring>
+#include <algorithm>
 #ifndef CH_DISABLE_SIGNALS
 #include <unistd.h>
 #include <csignal>
@@ -67,6 +69,23 @@ long long int TraceTimer::s_peak = 0;
 TraceTimer*  TraceTimer::s_peakTimer = NULL;
 bool TraceTimer::s_memorySampling = false;
 bool TraceTimer::s_tracing = false;
+bool TraceTimer::s_chromeTrace = false;
+
+//handed out to helper threads (see CH_Thread.H) so that their timers do nothing
+static TraceTimer* s_helperTimer = NULL;
+
+//one start/stop pair for the chrome trace, in ticks
+struct TraceEvent
+{
+  const char*            name;
+  unsigned long long int start;
+  unsigned long long int duration;
+};
+
+//events for each thread.  each thread only ever appends to its own.
+static std::vector<std::vector<TraceEvent> > s_traceEvents;
+static std::vector<unsigned long long int>   s_traceDropped;
+static size_t s_maxTraceEvents = 1<<20;
 
 static int s_depth = TraceTimer::initializer();
 
@@ -228,10 +247,20 @@ int TraceTimer::initializer()
   TraceTimer* rootTimer = new TraceTimer(rootName, NULL, 0);
   rootTimer->m_thread_id = 0;
   char mutex = 0;
-  s_roots.resize(1);
+  //every thread gets its own tree.  only thread 0's root runs.
+  int numThreads = getMaxThreads();
+  s_roots.resize(numThreads);
+  s_currentTimer.resize(numThreads);
   s_roots[0] = rootTimer;
-  s_currentTimer.resize(1);
   s_currentTimer[0]=rootTimer;
+  for (int ithread = 1; ithread < numThreads; ithread++)
+    {
+      s_roots[ithread] = new TraceTimer(rootName, NULL, ithread);
+      s_currentTimer[ithread] = s_roots[ithread];
+    }
+
+  s_helperTimer = new TraceTimer("helper", NULL, 0);
+  s_helperTimer->m_pruned = true;
 
   char* timerEnv = getenv("CH_TIMER");
   s_memorySampling = false;
@@ -242,7 +271,10 @@ int TraceTimer::initializer()
 
   if (timerEnv == NULL)
     {
-      rootTimer->m_pruned = true;
+      for (int ithread = 0; ithread < numThreads; ithread++)
+        {
+          s_roots[ithread]->m_pruned = true;
+        }
     }
   else if (strncmp(timerEnv, "SAMPLE=",7)==0)
     {
@@ -272,6 +304,20 @@ int TraceTimer::initializer()
 #endif
     }
 
+  char* chromeEnv = getenv("CH_TIMER_CHROME");
+  if ((timerEnv != NULL) && (chromeEnv != NULL))
+    {
+      s_chromeTrace = true;
+      char* maxEventsEnv = getenv("CH_TIMER_CHROME_EVENTS");
+      if (maxEventsEnv != NULL)
+        {
+          long maxEvents = atol(maxEventsEnv);
+          if (maxEvents > 0) s_maxTraceEvents = maxEvents;
+        }
+      s_traceEvents.resize(numThreads);
+      s_traceDropped.resize(numThreads, 0);
+    }
+
   //  OK, I think I have the atexit vs. static objects bug under AIX worked out. we'll see.
   //#ifndef CH_AIX
   // petermc, 21 April 2006:
@@ -485,8 +531,13 @@ void TraceTimer::report(bool a_closeAfter)
       fprintf(out, "stack top %p, stack bottom %p, stack size = %8.3f MB \n",
 	      root.m_name, bottom->m_name, ((double)(root.m_name-bottom->m_name))/(1024*1024));
       fprintf(out, "[%d] %s\n", bottom->m_rank, bottom->m_name);
+      reportThreads(out);
       fflush(out);
       if (a_closeAfter) fclose(out);
+      if (s_chromeTrace && (strcmp(buf, "/dev/null") != 0))
+        {
+          writeChromeTrace(mpirank);
+        }
     }
 
   if (s_memorySampling && !a_closeAfter) samplingOn = true; // enable sampling again.....
@@ -510,7 +561,15 @@ void TraceTimer::reset()
     }
   TraceTimer& root = *(s_roots[0]);
   root.currentize();
-  reset(root);
+  for (int ithread = 0; ithread < s_roots.size(); ithread++)
+    {
+      reset(*(s_roots[ithread]));
+    }
+  for (int ithread = 0; ithread < s_traceEvents.size(); ithread++)
+    {
+      s_traceEvents[ithread].clear();
+      s_traceDropped[ithread] = 0;
+    }
 #ifdef _OPENMP
   }
 #endif
@@ -761,6 +820,170 @@ void TraceTimer::reportPeak(FILE* out)
 #endif
 }
   
+//one node of the timer trees of all threads merged by call path
+struct MergedTimer
+{
+  MergedTimer(const char* a_name)
+    :name(a_name), time(0), count(0)
+  {
+  }
+
+  ~MergedTimer()
+  {
+    for (int i=0; i<children.size(); ++i)
+      {
+        delete children[i];
+      }
+  }
+
+  const char*                name;
+  unsigned long long int     time;
+  long long int              count;
+  std::vector<MergedTimer*>  children;
+};
+
+static void mergeTimer(MergedTimer& a_node, const TraceTimer& a_timer)
+{
+  a_node.time  += a_timer.time();
+  a_node.count += a_timer.count();
+  const std::vector<TraceTimer*>& children = a_timer.children();
+  for (int i=0; i<children.size(); ++i)
+    {
+      const TraceTimer& child = *(children[i]);
+      if (child.isPruned()) continue;
+      MergedTimer* node = NULL;
+      for (int j=0; j<a_node.children.size(); ++j)
+        {
+          if (strcmp(a_node.children[j]->name, child.name()) == 0)
+            {
+              node = a_node.children[j];
+              break;
+            }
+        }
+      if (node == NULL)
+        {
+          node = new MergedTimer(child.name());
+          a_node.children.push_back(node);
+        }
+      mergeTimer(*node, child);
+    }
+}
+
+static bool mergedTimeGreater(const MergedTimer* a_left, const MergedTimer* a_right)
+{
+  return a_left->time > a_right->time;
+}
+
+static void reportMergedTree(FILE* out, MergedTimer& a_node,
+                             unsigned long long int totalTime, int depth)
+{
+  for (int i=0; i<depth; ++i) fprintf(out,"   ");
+  double percent = ((double)a_node.time)/totalTime * 100.0;
+  fprintf(out, "%s %.4f %4.1f%% %lld\n", a_node.name,
+          a_node.time*secondspertick, percent, a_node.count);
+  std::sort(a_node.children.begin(), a_node.children.end(), mergedTimeGreater);
+  for (int i=0; i<a_node.children.size(); ++i)
+    {
+      reportMergedTree(out, *(a_node.children[i]), totalTime, depth+1);
+    }
+}
+
+void TraceTimer::reportThreads(FILE* out)
+{
+  //nothing to add unless some other thread timed something
+  bool workersTimed = false;
+  for (int ithread = 1; ithread < s_roots.size(); ithread++)
+    {
+      if (!s_roots[ithread]->m_pruned && (s_roots[ithread]->m_children.size() > 0))
+        {
+          workersTimed = true;
+        }
+    }
+  if (!workersTimed) return;
+
+  fprintf(out, "=======================================================\n");
+  fprintf(out, "Timers summed over %d threads (thread-seconds)\n", (int)s_roots.size());
+  MergedTimer root(s_roots[0]->m_name);
+  mergeTimer(root, *(s_roots[0]));
+  for (int ithread = 1; ithread < s_roots.size(); ithread++)
+    {
+      //the other threads' roots never run, so their time is what their children took
+      const TraceTimer& threadRoot = *(s_roots[ithread]);
+      unsigned long long int threadTime = 0;
+      for (int i=0; i<threadRoot.m_children.size(); ++i)
+        {
+          threadTime += threadRoot.m_children[i]->time();
+        }
+      fprintf(out, "  thread %d: %.4f in timers\n", ithread, threadTime*secondspertick);
+      mergeTimer(root, threadRoot);
+      root.time += threadTime;
+    }
+  if (root.time > 0)
+    {
+      reportMergedTree(out, root, root.time, 0);
+    }
+}
+
+//timer names are code labels but quote them properly anyway
+static void writeJSONString(FILE* out, const char* a_string)
+{
+  for (const char* c = a_string; *c != '\0'; ++c)
+    {
+      if ((*c == '"') || (*c == '\\'))
+        {
+          fputc('\\', out);
+          fputc(*c, out);
+        }
+      else if ((unsigned char)(*c) < 0x20)
+        {
+          fprintf(out, "\\u%04x", (int)(unsigned char)(*c));
+        }
+      else
+        {
+          fputc(*c, out);
+        }
+    }
+}
+
+void TraceTimer::writeChromeTrace(int a_rank)
+{
+  char buf[1024];
+#ifdef CH_MPI
+  sprintf(buf, "time.trace.%d.json", a_rank);
+#else
+  sprintf(buf, "time.trace.json");
+#endif
+  FILE* out = fopen(buf, "w");
+  if (out == NULL) return;
+
+  //each rank is a process, each thread a lane.  times are in
+  //microseconds from when this rank started its timers.
+  double microsecondspertick = 1.0e6*secondspertick;
+  unsigned long long int dropped = 0;
+  fprintf(out, "{\"traceEvents\":[\n");
+  fprintf(out, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,\"args\":{\"name\":\"rank %d\"}}",
+          a_rank, a_rank);
+  for (int ithread = 0; ithread < s_traceEvents.size(); ithread++)
+    {
+      dropped += s_traceDropped[ithread];
+      const std::vector<TraceEvent>& events = s_traceEvents[ithread];
+      if (events.size() == 0) continue;
+      fprintf(out, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}",
+              a_rank, ithread, ithread);
+      for (size_t iev = 0; iev < events.size(); iev++)
+        {
+          const TraceEvent& event = events[iev];
+          double start = (double)((long long int)(event.start - zeroTicks))*microsecondspertick;
+          fprintf(out, ",\n{\"name\":\"");
+          writeJSONString(out, event.name);
+          fprintf(out, "\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                  a_rank, ithread, start, event.duration*microsecondspertick);
+        }
+    }
+  fprintf(out, "\n],\n\"displayTimeUnit\":\"ms\",\n\"otherData\":{\"droppedEvents\":\"%llu\"}}\n", dropped);
+  fclose(out);
+}
+
 /*
 void TraceTimer::reportMemoryOneTree(FILE* out, const TraceTimer& timer)
 {
@@ -827,17 +1050,10 @@ bool AutoStartLeaf::active()
 
 TraceTimer::~TraceTimer()
 {
-#ifdef _OPENMP
-  if(onThread0()){
-#endif
-
   for (int i=0; i<m_children.size(); ++i)
     {
       delete m_children[i];
     }
-#ifdef _OPENMP
-  }
-#endif
 }
 
 void TraceTimer::reportName(std::ostream& out, const char* name)
@@ -857,12 +1073,24 @@ void TraceTimer::reportName(std::ostream& out, const char* name)
 #endif
 }
   
-TraceTimer* TraceTimer::getTimer(const char* name)
+int TraceTimer::threadIndex()
 {
+  if (onHelperThread()) return -1;
 #ifdef _OPENMP
-  if(onThread0()){
+  //threads of nested regions would share trees with the outer ones
+  if (omp_get_level() > 1) return -1;
+  int thread_id = omp_get_thread_num();
+  if (thread_id >= s_roots.size()) return -1;
+  return thread_id;
+#else
+  return 0;
 #endif
-  int thread_id = 0; // this line will change in MThread-aware code.
+}
+
+TraceTimer* TraceTimer::getTimer(const char* name)
+{
+  int thread_id = threadIndex();
+  if (thread_id < 0) return s_helperTimer;
   TraceTimer* parent = TraceTimer::s_currentTimer[thread_id];
   if (parent->m_pruned) return parent;
   std::vector<TraceTimer*>& children = parent->m_children;
@@ -875,29 +1103,8 @@ TraceTimer* TraceTimer::getTimer(const char* name)
   TraceTimer* newTimer = new TraceTimer(name, parent, thread_id);
   children.push_back(newTimer);
   return newTimer;
-#ifdef _OPENMP
-  }
-  return NULL;
-#endif
 }
 
-#ifdef _OPENMP
-TraceTimer::TraceTimer(const char* a_name, TraceTimer* parent, int thread_id)
-{
-  if(onThread0())
-    {
-      m_pruned =false;
-      m_parent = parent; 
-      m_name   = a_name;
-      m_count  = 0;
-      m_accumulated_WCtime = 0;
-      m_last_WCtime_stamp = 0;
-      m_thread_id = thread_id;
-      //m_memory = 0;
-      //m_peak = 0;
-    }
-}
-#else
 TraceTimer::TraceTimer(const char* a_name, TraceTimer* parent, int thread_id)
   :m_pruned(false), m_parent(parent), m_name(a_name), m_count(0),
    m_accumulated_WCtime(0),m_last_WCtime_stamp(0), m_thread_id(thread_id),
@@ -905,7 +1112,6 @@ TraceTimer::TraceTimer(const char* a_name, TraceTimer* parent, int thread_id)
 {
   m_memoryMin--;  // roll it back to the largest possible value;
 }
-#endif
 
 void TraceTimer::prune()
 {
@@ -926,10 +1132,10 @@ void TraceTimer::prune()
 
 void TraceTimer::start(char* mutex)
 {
+  if (m_pruned) return;
 #ifdef _OPENMP
-  if(onThread0()){
+  if (threadIndex() != m_thread_id) return;
 #endif
-  if (m_pruned) return;
 # ifndef NDEBUG
   if (*mutex == 1)
   {
@@ -941,31 +1147,28 @@ void TraceTimer::start(char* mutex)
   ++m_count;
   *mutex = 1;
   s_currentTimer[m_thread_id] = this;
-  if (s_memorySampling) //here's to hoping a two-bit branch predictor gets this right
+  //memory sampling is not thread safe so it only follows thread 0
+  if (s_memorySampling && (m_thread_id == 0)) //here's to hoping a two-bit branch predictor gets this right
     {
       unsigned int m = getMemorySize();
       m_memoryMin = std::min(m_memoryMin, m);
       m_memoryMax = std::max(m_memoryMax, m);
     }
-  if (s_tracing)
+  if (s_tracing && (m_thread_id == 0))
     {
       sampleMemUsage(m_name);
     }
   m_last_WCtime_stamp = ch_ticks();
-
-#ifdef _OPENMP
-  }
-#endif
 }
 unsigned long long int overflowLong = (unsigned long long int)1<<50;
 unsigned long long int TraceTimer::stop(char* mutex)
 {
+  if (m_pruned) return 0;
 #ifdef _OPENMP
-  if(onThread0()){
+  if (threadIndex() != m_thread_id) return 0;
 #endif
-  if (m_pruned) return 0;
 #ifndef NDEBUG
-  if (s_currentTimer[0] != this)
+  if (s_currentTimer[m_thread_id] != this)
     {
     char buf[1024];
     sprintf(buf, "TraceTimer::stop called while not parent: %s ",m_name);
@@ -977,13 +1180,29 @@ unsigned long long int TraceTimer::stop(char* mutex)
   if (diff > overflowLong) diff = 0;
   m_accumulated_WCtime += diff;
 
-  if (s_memorySampling) //here's to hoping a two-bit branch predictor gets this right
+  if (s_chromeTrace)
+    {
+      std::vector<TraceEvent>& events = s_traceEvents[m_thread_id];
+      if (events.size() < s_maxTraceEvents)
+        {
+          TraceEvent event;
+          event.name     = m_name;
+          event.start    = m_last_WCtime_stamp;
+          event.duration = diff;
+          events.push_back(event);
+        }
+      else
+        {
+          s_traceDropped[m_thread_id]++;
+        }
+    }
+  if (s_memorySampling && (m_thread_id == 0)) //here's to hoping a two-bit branch predictor gets this right
     {
       unsigned int m = getMemorySize();
       m_memoryMin = std::min(m_memoryMin, m);
       m_memoryMax = std::max(m_memoryMax, m);
     }
-  if (s_tracing)
+  if (s_tracing && (m_thread_id == 0))
     {
       sampleMemUsage("end");
     }
@@ -992,10 +1211,6 @@ unsigned long long int TraceTimer::stop(char* mutex)
   *mutex=0;
 
   return diff;
-#ifdef _OPENMP
-  }
-  return 0;
-#endif
 }
 
 void TraceTimer::macroTest2()
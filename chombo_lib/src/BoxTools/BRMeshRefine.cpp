@@ -193,11 +193,20 @@ BRMeshRefine::makeBoxes(Vector<Box>&         a_mesh,
   std::list<Box> boxes;
 
 #ifdef CH_MPI
-  int size;
-  MPI_Comm_size (Chombo_MPI::comm, &size );
-  Interval interval(0, size-1);
-  makeBoxesParallel(boxes, (IntVectSet&)a_tags, a_pnd, a_domain, a_maxBoxSize, 0, a_totalBufferSize,
-                    100, interval);
+  if (m_distributedClustering)
+    {
+      // a_tags holds only this rank's tags
+      makeBoxes(boxes, (IntVectSet&)a_tags, a_pnd, a_domain, a_maxBoxSize, 0, a_totalBufferSize);
+      mergeBoxesAcrossRanks(boxes);
+    }
+  else
+    {
+      int size;
+      MPI_Comm_size (Chombo_MPI::comm, &size );
+      Interval interval(0, size-1);
+      makeBoxesParallel(boxes, (IntVectSet&)a_tags, a_pnd, a_domain, a_maxBoxSize, 0, a_totalBufferSize,
+                        100, interval);
+    }
 #else
   makeBoxes(boxes, (IntVectSet&)a_tags, a_pnd, a_domain, a_maxBoxSize, 0, a_totalBufferSize);
 #endif
@@ -305,6 +314,111 @@ BRMeshRefine::makeBoxes(std::list<Box>&      a_mesh,
   // Done
 } //end of makeBoxes
 
+// Replace every box of a_pieces that intersects a_cut with at most
+// 2*SpaceDim boxes covering its part outside a_cut.
+static void removeFromPieces(std::list<Box>& a_pieces, const Box& a_cut)
+{
+  std::list<Box>::iterator it = a_pieces.begin();
+  while (it != a_pieces.end())
+    {
+      if (!it->intersectsNotEmpty(a_cut))
+        {
+          ++it;
+          continue;
+        }
+      Box rest = *it;
+      for (int idir = 0; idir < SpaceDim; idir++)
+        {
+          if (rest.smallEnd(idir) < a_cut.smallEnd(idir))
+            {
+              Box lo = rest;
+              lo.setBig(idir, a_cut.smallEnd(idir)-1);
+              a_pieces.insert(it, lo);
+              rest.setSmall(idir, a_cut.smallEnd(idir));
+            }
+          if (rest.bigEnd(idir) > a_cut.bigEnd(idir))
+            {
+              Box hi = rest;
+              hi.setSmall(idir, a_cut.bigEnd(idir)+1);
+              a_pieces.insert(it, hi);
+              rest.setBig(idir, a_cut.bigEnd(idir));
+            }
+        }
+      // what is left of *it is inside a_cut
+      it = a_pieces.erase(it);
+    }
+}
+
+void
+BRMeshRefine::mergeBoxesAcrossRanks(std::list<Box>& a_mesh) const
+{
+  CH_TIME("BRMeshRefine::mergeBoxesAcrossRanks");
+  const int dest_proc = uniqueProc(SerialTask::compute);
+
+  // every rank needs the boxes of the ranks below it
+  Vector<Box> localBoxes;
+  for (std::list<Box>::const_iterator it = a_mesh.begin(); it != a_mesh.end(); ++it)
+    {
+      localBoxes.push_back(*it);
+    }
+  Vector<Vector<Box> > allBoxes;
+  gather(allBoxes, localBoxes, dest_proc);
+  broadcast(allBoxes, dest_proc);
+
+  // Boxes of lower ranks win: clip ours against theirs.  The bounding box
+  // of each rank's boxes lets us skip ranks that are nowhere near ours.
+  if (!a_mesh.empty())
+    {
+      Box localMinBox = a_mesh.front();
+      for (std::list<Box>::const_iterator it = a_mesh.begin(); it != a_mesh.end(); ++it)
+        {
+          localMinBox.minBox(*it);
+        }
+      for (int iproc = 0; iproc < procID(); iproc++)
+        {
+          const Vector<Box>& other = allBoxes[iproc];
+          if (other.size() == 0) continue;
+          Box otherMinBox = other[0];
+          for (int ibox = 1; ibox < other.size(); ibox++)
+            {
+              otherMinBox.minBox(other[ibox]);
+            }
+          if (!otherMinBox.intersectsNotEmpty(localMinBox)) continue;
+          for (int ibox = 0; ibox < other.size(); ibox++)
+            {
+              if (other[ibox].intersectsNotEmpty(localMinBox))
+                {
+                  removeFromPieces(a_mesh, other[ibox]);
+                }
+            }
+        }
+    }
+  allBoxes.resize(0);
+
+  // now the pieces are disjoint; put them together in rank order
+  localBoxes.resize(0);
+  for (std::list<Box>::const_iterator it = a_mesh.begin(); it != a_mesh.end(); ++it)
+    {
+      localBoxes.push_back(*it);
+    }
+  gather(allBoxes, localBoxes, dest_proc);
+  Vector<Box> merged;
+  if (procID() == dest_proc)
+    {
+      for (int iproc = 0; iproc < allBoxes.size(); iproc++)
+        {
+          merged.append(allBoxes[iproc]);
+        }
+    }
+  broadcast(merged, dest_proc);
+
+  a_mesh.clear();
+  for (int ibox = 0; ibox < merged.size(); ibox++)
+    {
+      a_mesh.push_back(merged[ibox]);
+    }
+}
+
 void
 BRMeshRefine::makeBoxesParallel(std::list<Box>&      a_mesh,
                                 IntVectSet&    a_tags,
@@ -470,24 +584,8 @@ void BRMeshRefine::splitTagsInBestDimension(IntVectSet& a_tags_inout_lo,
   int infl_val [SpaceDim] ;                   //magnitudes of infl.points
   Vector<int> traces[SpaceDim];
 
-  //  makeTraces( a_tags_inout_lo, traces) ;
+  makeTraces( a_tags_inout_lo, traces) ;
   Box minbox = a_tags_inout_lo.minBox() ;
-  IntVect offset = minbox.smallEnd() ;
-  const IntVect& size = minbox.size();
-  D_TERM6(traces[0].resize(size[0],0);,
-          traces[1].resize(size[1],0);,
-          traces[2].resize(size[2],0);,
-          traces[3].resize(size[3],0);,
-          traces[4].resize(size[4],0);,
-          traces[5].resize(size[5],0););
-  IntVect iv;
-  IVSIterator i(a_tags_inout_lo);
-  for (i.begin() ; i.ok() ; ++i )
-  {
-    iv = i() - offset;
-    D_TERM6(traces[0][iv[0]]++,; traces[1][iv[1]]++,;traces[2][iv[2]]++,;
-            traces[3][iv[3]]++,; traces[4][iv[4]]++,;traces[5][iv[5]]++);
-  }
 
   for ( int idim = 0 ; idim < SpaceDim ; idim++ )
   {
@@ -648,24 +746,8 @@ BRMeshRefine::makeTrace( const IntVectSet& a_Ivs, int a_dir ) const
 
 void BRMeshRefine::makeTraces ( const IntVectSet& a_Ivs, Vector<int>* traces) const
 {
-  Box minbox = a_Ivs.minBox() ;
-  IntVect offset = minbox.smallEnd() ;
-  const IntVect& size = minbox.size();
-  D_TERM6(traces[0].resize(size[0],0);,
-          traces[1].resize(size[1],0);,
-          traces[2].resize(size[2],0);,
-          traces[3].resize(size[3],0);,
-          traces[4].resize(size[4],0);,
-          traces[5].resize(size[5],0););
-  IVSIterator i(a_Ivs) ;
-  for ( i.begin() ; i.ok() ; ++i )
-  {
-    IntVect iv = i();
-    iv-=offset;
-    D_TERM6(traces[0][iv[0]]++,; traces[1][iv[1]]++,;traces[2][iv[2]]++,;
-            traces[3][iv[3]]++,; traces[4][iv[4]]++,;traces[5][iv[5]]++);
-  }
-
+  // dense tag sets count whole rows of bits at a time
+  a_Ivs.makeTraces(traces);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
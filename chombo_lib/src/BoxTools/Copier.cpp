@@ -26,6 +26,8 @@ using std::ostream;
 
 Pool Copier::s_motionItemPool(sizeof(MotionItem), "Copier::MotionItem");
 
+bool CopierBuffer::s_usePersistentPlans = true;
+
 CopierBuffer::~CopierBuffer()
 {
   clear();
@@ -33,6 +35,9 @@ CopierBuffer::~CopierBuffer()
 
 void CopierBuffer::clear()
 {
+#ifdef CH_MPI
+  freePlan();
+#endif
   if (m_sendbuffer != NULL) freeMT(m_sendbuffer);
   if (m_recbuffer  != NULL) freeMT(m_recbuffer);
   m_sendbuffer = NULL;
@@ -40,8 +45,108 @@ void CopierBuffer::clear()
   m_sendcapacity = 0;
   m_reccapacity = 0;
   m_ncomps = 0;
+  m_bufferType.clear();
+}
+
+#ifdef CH_MPI
+// one persistent request per (processor, chunk) for a sorted list of entries
+static void initPlanRequests(const std::vector<CopierBuffer::bufEntry>& a_entries,
+                             std::vector<MPI_Request>&                  a_requests,
+                             bool                                       a_send)
+{
+  a_requests.resize(0);
+  long long maxSize = 0;
+  unsigned int i = 0;
+  while (i < a_entries.size())
+    {
+      // entries for one processor are contiguous in the buffer
+      unsigned int procID = a_entries[i].procID;
+      char* buffer = (char*)a_entries[i].bufPtr;
+      size_t bsize = 0;
+      for (; i < a_entries.size() && a_entries[i].procID == procID; ++i)
+        {
+          bsize += a_entries[i].size;
+        }
+
+      int idtag = 0;
+      while (bsize > CH_MAX_MPI_MESSAGE_SIZE)
+        {
+          a_requests.push_back(MPI_Request());
+          if (a_send)
+            {
+              MPI_Send_init(buffer, CH_MAX_MPI_MESSAGE_SIZE, MPI_BYTE, procID,
+                            idtag, Chombo_MPI::comm, &(a_requests.back()));
+            }
+          else
+            {
+              MPI_Recv_init(buffer, CH_MAX_MPI_MESSAGE_SIZE, MPI_BYTE, procID,
+                            idtag, Chombo_MPI::comm, &(a_requests.back()));
+            }
+          maxSize = CH_MAX_MPI_MESSAGE_SIZE;
+          bsize -= CH_MAX_MPI_MESSAGE_SIZE;
+          buffer += CH_MAX_MPI_MESSAGE_SIZE;
+          idtag++;
+        }
+      a_requests.push_back(MPI_Request());
+      if (a_send)
+        {
+          MPI_Send_init(buffer, bsize, MPI_BYTE, procID,
+                        idtag, Chombo_MPI::comm, &(a_requests.back()));
+        }
+      else
+        {
+          MPI_Recv_init(buffer, bsize, MPI_BYTE, procID,
+                        idtag, Chombo_MPI::comm, &(a_requests.back()));
+        }
+      maxSize = Max<long long>(bsize, maxSize);
+    }
+
+  if (a_send)
+    {
+      CH_MaxMPISendSize = Max<long long>(CH_MaxMPISendSize, maxSize);
+    }
+  else
+    {
+      CH_MaxMPIRecvSize = Max<long long>(CH_MaxMPIRecvSize, maxSize);
+    }
+}
+
+void CopierBuffer::buildPlan() const
+{
+  CH_TIME("CopierBuffer::buildPlan");
+  freePlan();
+
+  initPlanRequests(m_fromMe, m_sendPlan, true);
+  initPlanRequests(m_toMe,   m_recvPlan, false);
+
+  m_hasPlan = true;
 }
 
+void CopierBuffer::freePlan() const
+{
+  if (m_hasPlan)
+    {
+      // copiers can outlive MPI (statics, leaked objects)
+      int finalized = 0;
+      MPI_Finalized(&finalized);
+      if (!finalized)
+        {
+          for (unsigned int i = 0; i < m_sendPlan.size(); ++i)
+            {
+              MPI_Request_free(&(m_sendPlan[i]));
+            }
+          for (unsigned int i = 0; i < m_recvPlan.size(); ++i)
+            {
+              MPI_Request_free(&(m_recvPlan[i]));
+            }
+        }
+    }
+  m_sendPlan.resize(0);
+  m_recvPlan.resize(0);
+  m_hasPlan = false;
+}
+#endif
+
 Copier::Copier(const DisjointBoxLayout& a_level,
                const BoxLayout& a_dest,
                bool a_exchange,
@@ -98,6 +203,7 @@ void Copier::clear()
   m_localMotionPlan.resize(0);
   m_fromMotionPlan.resize(0);
   m_toMotionPlan.resize(0);
+  invalidateLocalGroups();
   m_isDefined = false;
   m_buffers.clear();
 }
@@ -129,6 +235,7 @@ Copier& Copier::operator= (const Copier& b)
       m_toMotionPlan[i] = new (s_motionItemPool.getPtr()) MotionItem(*(b.m_toMotionPlan[i]));
     }
 
+  m_buffers.m_fixedSizes = b.m_buffers.m_fixedSizes;
   m_isDefined = true;
   return *this;
 }
@@ -183,7 +290,7 @@ void Copier::reverse()
       m_toMotionPlan[i]->reverse();
     }
   m_fromMotionPlan.swap(m_toMotionPlan);
-
+  invalidateLocalGroups();
 }
 
 void Copier::coarsen(int a_refRatio)
@@ -820,6 +927,54 @@ void Copier::sort()
   std::sort(vfrom.begin(), vfrom.end(), MotionItemSorter());
   std::vector<MotionItem*>& vto = m_toMotionPlan.stdVector();
   std::sort(vto.begin(), vto.end(), MotionItemSorter());
+  invalidateLocalGroups();
+}
+
+void Copier::invalidateLocalGroups()
+{
+  m_localGroupStart.resize(0);
+  m_localGroupOrder.resize(0);
+}
+
+void Copier::buildLocalGroups() const
+{
+  int nitems = m_localMotionPlan.size();
+  std::vector<std::pair<int, int> > keys(nitems);
+  for (int i = 0; i < nitems; ++i)
+    {
+      keys[i] = std::pair<int, int>(m_localMotionPlan[i]->toIndex.intCode(), i);
+    }
+  // pairs sort by destination, then by position in the plan, so items
+  // that land in the same box keep their relative order.
+  std::sort(keys.begin(), keys.end());
+
+  m_localGroupOrder.resize(nitems);
+  m_localGroupStart.resize(0);
+  for (int i = 0; i < nitems; ++i)
+    {
+      if (i == 0 || keys[i].first != keys[i-1].first)
+        {
+          m_localGroupStart.push_back(i);
+        }
+      m_localGroupOrder[i] = keys[i].second;
+    }
+  m_localGroupStart.push_back(nitems);
+}
+
+const Vector<int>& Copier::localGroupStart() const
+{
+  if (m_localGroupStart.size() == 0 ||
+      m_localGroupOrder.size() != m_localMotionPlan.size())
+    {
+      buildLocalGroups();
+    }
+  return m_localGroupStart;
+}
+
+const Vector<int>& Copier::localGroupOrder() const
+{
+  localGroupStart();
+  return m_localGroupOrder;
 }
 
 int Copier::print() const
@@ -819,11 +819,49 @@ bool DenseIntVectSet::isFull() const
 
 int DenseIntVectSet::numPts() const
 {
-  int n = m_domain.numPts();
-  int c=0;
-  for (int i=0; i<n; ++i)
-    if (m_bits[i]) ++c;
-  return c;
+  return m_bits.countTrue(0, m_domain.numPts());
+}
+
+void DenseIntVectSet::makeTraces(Vector<int>* a_traces, const Box& a_box) const
+{
+  for (int idir = 0; idir < SpaceDim; idir++)
+    {
+      a_traces[idir].resize(0);
+      a_traces[idir].resize(a_box.isEmpty() ? 0 : a_box.size(idir), 0);
+    }
+  // there are no bits outside m_domain
+  Box region = a_box & m_domain;
+  if (region.isEmpty()) return;
+
+  const IntVect& offset = a_box.smallEnd();
+  const IntVect& lo = region.smallEnd();
+  const IntVect& hi = region.bigEnd();
+  const int rowLength = region.size(0);
+  int* xtrace = &(a_traces[0][lo[0] - offset[0]]);
+  IntVect iv = lo;
+  while (true)
+    {
+      int count = m_bits.countTrue(m_domain.index(iv), rowLength, xtrace);
+      if (count > 0)
+        {
+          for (int idir = 1; idir < SpaceDim; idir++)
+            {
+              a_traces[idir][iv[idir] - offset[idir]] += count;
+            }
+        }
+      // next row: advance the transverse indices like an odometer
+      int idir = 1;
+      for (; idir < SpaceDim; idir++)
+        {
+          if (iv[idir] < hi[idir])
+            {
+              iv[idir]++;
+              break;
+            }
+          iv[idir] = lo[idir];
+        }
+      if (idir == SpaceDim) break;
+    }
 }
 
 bool DenseIntVectSet::operator==(const DenseIntVectSet& a_lhs) const
@@ -27,6 +27,7 @@ using std::sqrt;
 #include "Misc.H"
 #include "FArrayBox.H"
 #include "MayDay.H"
+#include "BoxIterator.H"
 #include "NamespaceHeader.H"
 
 FArrayBox::FArrayBox()
@@ -1284,4 +1285,72 @@ void FArrayBox::performCopy(const BaseFab<Real>& a_src,
   //                  CHF_CONST_INT(a_destcomp),
   //                  CHF_CONST_INT(a_numcomp));
 }
+
+void copyRealRows(BaseFab<Real>&       a_dest,
+                  const Box&           a_regionFrom,
+                  const Interval&      a_Cdest,
+                  const Box&           a_regionTo,
+                  const BaseFab<Real>& a_src,
+                  const Interval&      a_Csrc)
+{
+  if ((&a_dest == &a_src) && (a_regionFrom == a_regionTo) && (a_Cdest == a_Csrc))
+    {
+      return;
+    }
+  if (&a_dest == &a_src)
+    {
+      // a periodic self-exchange copies between disjoint regions of one
+      // fab, which memcpy handles.  Overlapping rows go through copy().
+      bool compsOverlap = (a_Cdest.begin() <= a_Csrc.end()) &&
+                          (a_Csrc.begin() <= a_Cdest.end());
+      if (compsOverlap && a_regionFrom.intersects(a_regionTo))
+        {
+          a_dest.copy(a_regionFrom, a_Cdest, a_regionTo, a_src, a_Csrc);
+          return;
+        }
+    }
+  CH_assert(a_Cdest.size() == a_Csrc.size());
+  CH_assert(a_regionFrom.sameSize(a_regionTo));
+  CH_assert(a_src.box().contains(a_regionFrom));
+  CH_assert(a_dest.box().contains(a_regionTo));
+  CH_assert(a_Csrc.begin()  >= 0 && a_Csrc.end()  < a_src.nComp());
+  CH_assert(a_Cdest.begin() >= 0 && a_Cdest.end() < a_dest.nComp());
+
+  if (a_regionTo.isEmpty())
+    {
+      return;
+    }
+
+  const Box& srcBox  = a_src.box();
+  const Box& destBox = a_dest.box();
+  const int ncomp = a_Cdest.size();
+
+  // whole-fab to whole-fab: each component is one block
+  if ((a_regionFrom == srcBox) && (a_regionTo == destBox))
+    {
+      size_t nbytes = a_regionTo.numPts()*sizeof(Real);
+      for (int icomp = 0; icomp < ncomp; icomp++)
+        {
+          memcpy(a_dest.dataPtr(a_Cdest.begin() + icomp),
+                 a_src.dataPtr(a_Csrc.begin() + icomp), nbytes);
+        }
+      return;
+    }
+
+  size_t rowBytes = a_regionTo.size(0)*sizeof(Real);
+  Box rows(a_regionTo);
+  rows.setBig(0, a_regionTo.smallEnd(0));
+  const IntVect shift = a_regionFrom.smallEnd() - a_regionTo.smallEnd();
+  for (int icomp = 0; icomp < ncomp; icomp++)
+    {
+      Real*       destData = a_dest.dataPtr(a_Cdest.begin() + icomp);
+      const Real* srcData  = a_src.dataPtr(a_Csrc.begin() + icomp);
+      for (BoxIterator bit(rows); bit.ok(); ++bit)
+        {
+          const IntVect& ivTo = bit();
+          memcpy(destData + destBox.index(ivTo),
+                 srcData  + srcBox.index(ivTo + shift), rowBytes);
+        }
+    }
+}
 #include "NamespaceFooter.H"
@@ -15,49 +15,70 @@
 long int IntVectSet::count = 0;
 long int IntVectSet::peakcount = 0;
 int      IntVectSet::s_maxDense = 6400000;
+int      IntVectSet::s_sparseRatio = 8;
 
 IntVectSet::~IntVectSet()
 {
-  count--;
+  subtractCount();
 }
 
 void IntVectSet::define()
 {
   m_ivs.clear();
+  m_run.clear();
   m_dense = DenseIntVectSet();
   m_isdense = true;
+  m_isrun = false;
 }
 
 void IntVectSet::define(const DenseIntVectSet& a_dense)
 {
   m_ivs.clear();
+  m_run.clear();
   m_dense = a_dense;
   m_isdense = true;
+  m_isrun = false;
 }
 
 void IntVectSet::define(const TreeIntVectSet& a_tree)
 {
   m_ivs = a_tree;
+  m_run.clear();
   m_dense = DenseIntVectSet();
   m_isdense = false;
+  m_isrun = false;
+}
+
+void IntVectSet::define(const RunIntVectSet& a_run)
+{
+  m_ivs.clear();
+  m_run = a_run;
+  m_dense = DenseIntVectSet();
+  m_isdense = false;
+  m_isrun = true;
 }
 
 IntVectSet::IntVectSet(const DenseIntVectSet& a_dense)
 {
-  count++;
+  addCount(false);
   define(a_dense);
 }
 
 IntVectSet::IntVectSet(const TreeIntVectSet& a_tree)
 {
-  count++;
+  addCount(false);
   define(a_tree);
 }
 
+IntVectSet::IntVectSet(const RunIntVectSet& a_run)
+{
+  addCount(false);
+  define(a_run);
+}
+
 IntVectSet::IntVectSet(const IntVect& iv_in)
 {
-  count++;
-  if (count > peakcount) peakcount = count;
+  addCount(true);
   define(iv_in);
 }
 
@@ -68,8 +89,7 @@ void IntVectSet::define(const IntVect& iv_in)
 
 IntVectSet::IntVectSet(const Box& b)
 {
-  count++;
-  if (count > peakcount) peakcount = count;
+  addCount(true);
   define(b);
 }
 
@@ -78,8 +98,24 @@ IntVectSet::setMaxDense(const int& a_maxDense)
 {
   s_maxDense = a_maxDense;
 }
+
+void
+IntVectSet::setSparseRatio(const int& a_sparseRatio)
+{
+  CH_assert(a_sparseRatio > 0);
+  s_sparseRatio = a_sparseRatio;
+}
+
+bool IntVectSet::isSparse(const DenseIntVectSet& a_dense)
+{
+  if (a_dense.isEmpty()) return true;
+  return (long long)a_dense.numPts()*s_sparseRatio < (long long)a_dense.box().numPts();
+}
+
 void IntVectSet::define(const Box& b)
 {
+  m_run.clear();
+  m_isrun = false;
   if (b.numPts() < s_maxDense)
     {
       m_ivs.clear();
@@ -176,14 +212,28 @@ IntVectSet& IntVectSet::operator|=(const IntVect& iv)
   {
         if (!m_dense.box().contains(iv))
         {
-          convert();
-          m_ivs |= iv;
+          // sets built up one cell at a time are mostly tags and
+          // irregular cells: thin, and cheapest as runs
+          if (isSparse(m_dense))
+            {
+              convertToRuns();
+              m_run |= iv;
+            }
+          else
+            {
+              convert();
+              m_ivs |= iv;
+            }
         }
         else
         {
           m_dense |= iv;
         }
   }
+  else if (m_isrun)
+  {
+        m_run |= iv;
+  }
   else
   {
         m_ivs |= iv;
@@ -205,6 +255,10 @@ IntVectSet& IntVectSet::operator|=(const Box& b)
           m_dense |= b;
         }
   }
+  else if (m_isrun)
+  {
+        m_run |= b;
+  }
   else
   {
         m_ivs |= b;
@@ -225,14 +279,49 @@ IntVectSet& IntVectSet::operator|=(const IntVectSet& ivs)
               m_dense |= ivs.m_dense;
               return *this;
             }
+          if (isSparse(m_dense) && isSparse(ivs.m_dense))
+            {
+              convertToRuns();
+              m_run |= RunIntVectSet(ivs.m_dense);
+              return *this;
+            }
           ivs.convert();
         }
+      else if (ivs.m_isrun)
+        {
+          convertToRuns();
+          m_run |= ivs.m_run;
+          return *this;
+        }
+      convert();
+    }
+  else if (m_isrun)
+    {
+      if (ivs.m_isdense)
+        {
+          m_run |= RunIntVectSet(ivs.m_dense);
+          return *this;
+        }
+      if (ivs.m_isrun)
+        {
+          m_run |= ivs.m_run;
+          return *this;
+        }
       convert();
     }
   else if (ivs.m_isdense)
     {
       ivs.convert();
     }
+  else if (ivs.m_isrun)
+    {
+      Vector<Box> runBoxes = ivs.m_run.createBoxes();
+      for (int ibox = 0; ibox < runBoxes.size(); ibox++)
+        {
+          m_ivs |= runBoxes[ibox];
+        }
+      return *this;
+    }
   m_ivs |= ivs.m_ivs;
   return *this;
 }
@@ -264,17 +353,33 @@ IntVectSet& IntVectSet::operator-=(const IntVectSet& ivs)
   if (m_isdense)
     {
       if (ivs.m_isdense) m_dense-=ivs.m_dense;
+      else if (ivs.m_isrun)
+        {
+          Vector<Box> runBoxes = ivs.m_run.createBoxes();
+          for (int ibox = 0; ibox < runBoxes.size(); ibox++) m_dense -= runBoxes[ibox];
+        }
       else
         {
           for (TreeIntVectSetIterator it(ivs.m_ivs); it.ok(); ++it) m_dense -= it();
         }
     }
+  else if (m_isrun)
+    {
+      if (ivs.m_isdense)     m_run -= RunIntVectSet(ivs.m_dense);
+      else if (ivs.m_isrun)  m_run -= ivs.m_run;
+      else                   m_run -= RunIntVectSet(ivs.m_ivs, m_run.minBox());
+    }
   else
     {
       if (ivs.m_isdense)
         {
           for (DenseIntVectSetIterator it(ivs.m_dense);it.ok(); ++it) m_ivs -= it();
         }
+      else if (ivs.m_isrun)
+        {
+          Vector<Box> runBoxes = ivs.m_run.createBoxes();
+          for (int ibox = 0; ibox < runBoxes.size(); ibox++) m_ivs -= runBoxes[ibox];
+        }
       else
         m_ivs -= ivs.m_ivs;
     }
@@ -284,41 +389,48 @@ IntVectSet& IntVectSet::operator-=(const IntVectSet& ivs)
 
 bool IntVectSet::operator==(const IntVectSet& a_lhs) const
 {
-  if (m_isdense)
+  if ((m_isrun != a_lhs.m_isrun) || (m_isdense != a_lhs.m_isdense))
   {
-    if (!a_lhs.m_isdense) return false;
-    return m_dense == a_lhs.m_dense;
+    // different representations: compare the contents as runs, which
+    // have a canonical form
+    if (numPts() != a_lhs.numPts()) return false;
+    return asRuns() == a_lhs.asRuns();
   }
-  if (a_lhs.m_isdense) return false;
+  if (m_isrun)   return m_run == a_lhs.m_run;
+  if (m_isdense) return m_dense == a_lhs.m_dense;
   return m_ivs == a_lhs.m_ivs;
 }
 
 bool IntVectSet::operator<(const IntVectSet& a_ivs) const
 {
-  if ( m_isdense )
+  if ((m_isrun != a_ivs.m_isrun) || (m_isdense != a_ivs.m_isdense))
   {
-    if ( !a_ivs.m_isdense )
-    {
-      return true;
-    } else
-    {
-      return m_dense < a_ivs.m_dense;
-    }
-  } else
+    // ordered by content, like operator==
+    return asRuns() < a_ivs.asRuns();
+  }
+  if ( m_isrun )
   {
-    if ( !a_ivs.m_isdense )
-    {
-      return m_ivs < a_ivs.m_ivs;
-    } else
-    {
-      return false;
-    }
+    return m_run < a_ivs.m_run;
+  }
+  if ( m_isdense )
+  {
+    return m_dense < a_ivs.m_dense;
   }
+  return m_ivs < a_ivs.m_ivs;
+}
+
+RunIntVectSet IntVectSet::asRuns() const
+{
+  if (m_isrun)   return m_run;
+  if (m_isdense) return RunIntVectSet(m_dense);
+  m_ivs.recalcMinBox();
+  return RunIntVectSet(m_ivs, m_ivs.minBox());
 }
 
 int IntVectSet::linearSize() const
 {
   if (m_isdense) return m_dense.linearSize() + sizeof(int);
+  if (m_isrun)   return m_run.linearSize() + sizeof(int);
   return m_ivs.linearSize() + sizeof(int);
 }
 
@@ -330,11 +442,19 @@ void IntVectSet::linearIn(const void* const inBuf)
   if (*b == 0)
   {
     m_isdense = true;
+    m_isrun = false;
     m_dense.linearIn(buf);
   }
+  else if (*b == 2)
+  {
+    m_isdense = false;
+    m_isrun = true;
+    m_run.linearIn(buf);
+  }
   else
   {
     m_isdense = false;
+    m_isrun = false;
     m_ivs.linearIn(buf);
   }
 }
@@ -348,6 +468,11 @@ void IntVectSet::linearOut(void* const a_outBuf) const
     *b=0;
     m_dense.linearOut(buf);
   }
+  else if (m_isrun)
+  {
+    *b=2;
+    m_run.linearOut(buf);
+  }
   else
   {
     *b=1;
@@ -357,15 +482,17 @@ void IntVectSet::linearOut(void* const a_outBuf) const
 
 IntVectSet& IntVectSet::operator-=(const IntVect& iv)
 {
-  if (m_isdense) m_dense -= iv;
-  else          m_ivs   -= iv;
+  if (m_isdense)    m_dense -= iv;
+  else if (m_isrun) m_run   -= iv;
+  else              m_ivs   -= iv;
   return *this;
 }
 
 IntVectSet& IntVectSet::operator-=(const Box& b)
 {
-  if (m_isdense) m_dense -= b;
-  else          m_ivs   -= b;
+  if (m_isdense)    m_dense -= b;
+  else if (m_isrun) m_run   -= b;
+  else              m_ivs   -= b;
   return *this;
 }
 
@@ -392,15 +519,17 @@ IntVectSet operator&(const Box& b, const IntVectSet& ivs)
 
 IntVectSet& IntVectSet::operator&=(const Box& b)
 {
-  if (m_isdense) m_dense &= b;
-  else          m_ivs   &= b;
+  if (m_isdense)    m_dense &= b;
+  else if (m_isrun) m_run   &= b;
+  else              m_ivs   &= b;
   return *this;
 }
 
 IntVectSet& IntVectSet::operator&=(const ProblemDomain& d)
 {
-  if (m_isdense) m_dense &= d;
-  else          m_ivs   &= d;
+  if (m_isdense)    m_dense &= d;
+  else if (m_isrun) m_run   &= d;
+  else              m_ivs   &= d;
   return *this;
 }
 
@@ -408,22 +537,39 @@ IntVectSet& IntVectSet::operator&=(const IntVectSet& ivs)
 {
   if (!(minBox().intersects(ivs.minBox())))
     {
-      m_ivs.clear();
-      m_isdense = true;
-      m_dense = DenseIntVectSet();
+      define();
       return *this;
     }
   if (m_isdense)
     {
       if (ivs.m_isdense) m_dense&=ivs.m_dense;
+      else if (ivs.m_isrun)
+        {
+          convertToRuns();
+          m_run &= ivs.m_run;
+        }
       else
         {
           convert();
           m_ivs &= ivs.m_ivs;
         }
     }
+  else if (m_isrun)
+    {
+      if (ivs.m_isdense)     m_run &= RunIntVectSet(ivs.m_dense);
+      else if (ivs.m_isrun)  m_run &= ivs.m_run;
+      else                   m_run &= RunIntVectSet(ivs.m_ivs, m_run.minBox());
+    }
   else
     {
+      if (ivs.m_isrun)
+        {
+          // the result is no bigger than the runs, so keep it as runs
+          m_ivs &= ivs.minBox();
+          convertToRuns();
+          m_run &= ivs.m_run;
+          return *this;
+        }
       if (ivs.m_isdense) ivs.convert();
         m_ivs &= ivs.m_ivs;
     }
@@ -440,19 +586,22 @@ IntVectSet grow(const IntVectSet& ivs, int igrow)
 
 void IntVectSet::grow(int igrow)
 {
-  if (m_isdense) m_dense.grow(igrow);
-  else          m_ivs.grow(igrow);
+  if (m_isdense)    m_dense.grow(igrow);
+  else if (m_isrun) m_run.grow(igrow);
+  else              m_ivs.grow(igrow);
   //  return *this;
 }
 
 void IntVectSet::nestingRegion(int radius, const Box& domain, int granularity)
 {
+  if (m_isrun) convert();
   if (m_isdense) m_dense.nestingRegion(radius, domain);
   else          m_ivs.nestingRegion(radius, domain, granularity);
 }
 
 void IntVectSet::nestingRegion(int radius, const ProblemDomain& domain, int granularity)
 {
+  if (m_isrun) convert();
   if (m_isdense) m_dense.nestingRegion(radius, domain);
   else          m_ivs.nestingRegion(radius, domain, granularity);
 }
@@ -461,21 +610,24 @@ IntVectSet& IntVectSet::grow(int idir, int igrow)
 {
   CH_assert(idir >= 0);
   CH_assert(idir < SpaceDim);
-  if (m_isdense) m_dense.grow(idir, igrow);
-  else          m_ivs.grow(idir, igrow);
+  if (m_isdense)    m_dense.grow(idir, igrow);
+  else if (m_isrun) m_run.grow(idir, igrow);
+  else              m_ivs.grow(idir, igrow);
   return *this;
 }
 
 void IntVectSet::growHi()
 {
-  if (m_isdense) m_dense.growHi();
-  else          m_ivs.growHi();
+  if (m_isdense)    m_dense.growHi();
+  else if (m_isrun) m_run.growHi();
+  else              m_ivs.growHi();
 }
 
 void IntVectSet::growHi(const int a_dir)
 {
-  if (m_isdense) m_dense.growHi(a_dir);
-  else          m_ivs.growHi(a_dir);
+  if (m_isdense)    m_dense.growHi(a_dir);
+  else if (m_isrun) m_run.growHi(a_dir);
+  else              m_ivs.growHi(a_dir);
 }
 
 IntVectSet refine(const IntVectSet& ivs, int iref)
@@ -487,8 +639,9 @@ IntVectSet refine(const IntVectSet& ivs, int iref)
 
 IntVectSet& IntVectSet::refine(int iref)
 {
-  if (m_isdense) m_dense.refine(iref);
-  else          m_ivs.refine(iref);
+  if (m_isdense)    m_dense.refine(iref);
+  else if (m_isrun) m_run.refine(iref);
+  else              m_ivs.refine(iref);
   return *this;
 }
 
@@ -501,33 +654,38 @@ IntVectSet coarsen(const IntVectSet& ivs, int iref)
 
 IntVectSet& IntVectSet::coarsen(int iref)
 {
-  if (m_isdense) m_dense.coarsen(iref);
-  else          m_ivs.coarsen(iref);
+  if (m_isdense)    m_dense.coarsen(iref);
+  else if (m_isrun) m_run.coarsen(iref);
+  else              m_ivs.coarsen(iref);
   return *this;
 }
 
 void IntVectSet::shift(const IntVect& iv)
 {
-  if (m_isdense) m_dense.shift(iv);
-  else          m_ivs.shift(iv);
+  if (m_isdense)    m_dense.shift(iv);
+  else if (m_isrun) m_run.shift(iv);
+  else              m_ivs.shift(iv);
 }
 
 void IntVectSet::makeEmpty()
 {
-  if (m_isdense) m_dense = DenseIntVectSet();
-  else          m_ivs.clear();
+  if (m_isdense)    m_dense = DenseIntVectSet();
+  else if (m_isrun) m_run.clear();
+  else              m_ivs.clear();
 }
 
 void IntVectSet::makeEmptyBits()
 {
-  if (m_isdense) m_dense.makeEmptyBits();
-  else          m_ivs.clear();
+  if (m_isdense)    m_dense.makeEmptyBits();
+  else if (m_isrun) m_run.clear();
+  else              m_ivs.clear();
 }
 
 void IntVectSet::compact() const
 {
-  if (m_isdense) m_dense.compact();
-  else          m_ivs.compact();
+  if (m_isdense)    m_dense.compact();
+  else if (m_isrun) m_run.compact();
+  else              m_ivs.compact();
 }
 
 IntVectSet IntVectSet::chop(int dir, int chop_pnt)
@@ -538,6 +696,12 @@ IntVectSet IntVectSet::chop(int dir, int chop_pnt)
         IntVectSet rtn(r);
         return rtn;
   }
+  else if (m_isrun)
+  {
+        RunIntVectSet r = m_run.chop(dir, chop_pnt);
+        IntVectSet rtn(r);
+        return rtn;
+  }
   else
   {
         TreeIntVectSet t = m_ivs.chop(dir, chop_pnt);
@@ -549,18 +713,21 @@ IntVectSet IntVectSet::chop(int dir, int chop_pnt)
 
 void IntVectSet::chop(int dir, int chop_pnt, IntVectSet& a_hi)
 {
-  if (m_isdense)
+  if (m_isdense || m_isrun)
     a_hi = chop(dir, chop_pnt);
   else
     {
+      a_hi.m_run.clear();
       m_ivs.chop(dir, chop_pnt, a_hi.m_ivs);
       a_hi.m_isdense = false;
+      a_hi.m_isrun = false;
     }
 
 }
 const Box& IntVectSet::minBox() const
 {
   if (m_isdense) return m_dense.mBox();
+  if (m_isrun)   return m_run.minBox();
   m_ivs.recalcMinBox();
   return m_ivs.minBox();
 }
@@ -569,25 +736,60 @@ void IntVectSet::recalcMinBox() const
 {
    if (m_isdense)
      m_dense.recalcMinBox();
+   else if (m_isrun)
+     m_run.minBox();
    else
      m_ivs.recalcMinBox();
 }
 
+void IntVectSet::makeTraces(Vector<int>* a_traces) const
+{
+  const Box& minbox = minBox();
+  if (m_isdense)
+    {
+      m_dense.makeTraces(a_traces, minbox);
+      return;
+    }
+  if (m_isrun)
+    {
+      m_run.makeTraces(a_traces, minbox);
+      return;
+    }
+  for (int idir = 0; idir < SpaceDim; idir++)
+    {
+      a_traces[idir].resize(0);
+      a_traces[idir].resize(minbox.isEmpty() ? 0 : minbox.size(idir), 0);
+    }
+  const IntVect& offset = minbox.smallEnd();
+  IVSIterator it(*this);
+  for (it.begin(); it.ok(); ++it)
+    {
+      const IntVect& iv = it();
+      for (int idir = 0; idir < SpaceDim; idir++)
+        {
+          a_traces[idir][iv[idir] - offset[idir]]++;
+        }
+    }
+}
+
 bool IntVectSet::isEmpty() const
 {
   if (m_isdense) return m_dense.isEmpty();
+  if (m_isrun)   return m_run.isEmpty();
   return m_ivs.isEmpty();
 }
 
 int IntVectSet::numPts() const
 {
   if (m_isdense) return m_dense.numPts();
+  if (m_isrun)   return m_run.numPts();
   return m_ivs.numPts();
 }
 
 bool IntVectSet::contains(const IntVect& iv) const
 {
   if (m_isdense) return m_dense[iv];
+  if (m_isrun)   return m_run.contains(iv);
   return m_ivs.contains(iv);
 }
 
@@ -606,12 +808,14 @@ bool IntVectSet::contains(const IntVectSet& ivs) const
 bool IntVectSet::contains(const Box& box) const
 {
   if (m_isdense) return m_dense.contains(box);
+  if (m_isrun)   return m_run.contains(box);
   return m_ivs.contains(box);
 }
 
 Vector<Box> IntVectSet::boxes() const
 {
   if (m_isdense) return m_dense.createBoxes();
+  if (m_isrun)   return m_run.createBoxes();
   return m_ivs.createBoxes();
 }
 
@@ -629,6 +833,18 @@ std::ostream& operator<<(std::ostream& os, const IntVectSet& ivs)
 
 void IntVectSet::convert() const
 {
+  if (m_isrun)
+    {
+      Vector<Box> runBoxes = m_run.createBoxes();
+      for (int ibox = 0; ibox < runBoxes.size(); ibox++)
+        {
+          ((TreeIntVectSet&)m_ivs) |= runBoxes[ibox];
+        }
+      m_ivs.compact();
+      ((RunIntVectSet&)m_run).clear();
+      (bool&)m_isrun = false;
+      return;
+    }
   if (!m_isdense) return; //already converted
   if (m_dense.isEmpty())
   {
@@ -650,6 +866,66 @@ void IntVectSet::convert() const
   (bool&)m_isdense = false;
 }
 
+void IntVectSet::convertToRuns() const
+{
+  if (m_isrun) return; //already converted
+  if (m_isdense)
+    {
+      ((RunIntVectSet&)m_run).define(m_dense);
+      ((DenseIntVectSet&)m_dense) = DenseIntVectSet();
+      (bool&)m_isdense = false;
+    }
+  else
+    {
+      m_ivs.recalcMinBox();
+      ((RunIntVectSet&)m_run).define(m_ivs, m_ivs.minBox());
+      ((TreeIntVectSet&)m_ivs).clear();
+    }
+  (bool&)m_isrun = true;
+}
+
+void IntVectSet::compress() const
+{
+  if (m_isdense)
+    {
+      // a bit per cell of the box against a run per row segment
+      if (isSparse(m_dense))
+        {
+          RunIntVectSet runs(m_dense);
+          runs.compact();
+          if (8*runs.memory() < m_dense.box().numPts())
+            {
+              ((RunIntVectSet&)m_run) = runs;
+              ((DenseIntVectSet&)m_dense) = DenseIntVectSet();
+              (bool&)m_isdense = false;
+              (bool&)m_isrun = true;
+              return;
+            }
+        }
+      m_dense.compact();
+    }
+  else if (m_isrun)
+    {
+      const Box& minbox = m_run.minBox();
+      if (!minbox.isEmpty() && (minbox.numPts() < s_maxDense) &&
+          (minbox.numPts() < 8*m_run.memory()))
+        {
+          DenseIntVectSet dense(minbox, false);
+          Vector<Box> runBoxes = m_run.createBoxes();
+          for (int ibox = 0; ibox < runBoxes.size(); ibox++)
+            {
+              dense |= runBoxes[ibox];
+            }
+          ((DenseIntVectSet&)m_dense) = dense;
+          ((RunIntVectSet&)m_run).clear();
+          (bool&)m_isdense = true;
+          (bool&)m_isrun = false;
+          return;
+        }
+      m_run.compact();
+    }
+}
+
 // if you are in this function, you better really
 // have returned all the TreeNodes to the pool before
 // you call this function!!
@@ -674,11 +950,19 @@ void IVSIterator::define(const IntVectSet& ivs)
   if (ivs.m_isdense)
     {
       m_isdense = true;
+      m_isrun = false;
       m_dense.define(ivs.m_dense);
     }
+  else if (ivs.m_isrun)
+    {
+      m_isdense = false;
+      m_isrun = true;
+      m_run.define(ivs.m_run);
+    }
   else
     {
       m_isdense = false;
+      m_isrun = false;
       m_tree.define(ivs.m_ivs);
     }
 }
@@ -280,7 +280,8 @@ using std::endl;
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-MeshRefine::MeshRefine() : m_isDefined(false), m_granularity(1)
+MeshRefine::MeshRefine() : m_isDefined(false), m_granularity(1),
+                           m_distributedClustering(false)
 {
 }
 
@@ -294,7 +295,7 @@ MeshRefine::MeshRefine(const Box& a_baseDomain,
                        const int a_blockFactor,
                        const int a_bufferSize,
                        const int a_maxBoxSize)
-  :m_granularity(1)
+  :m_granularity(1), m_distributedClustering(false)
 {
   ProblemDomain crseDom(a_baseDomain);
   define(crseDom, a_refRatios, a_fillRatio, a_blockFactor,
@@ -307,7 +308,7 @@ MeshRefine::MeshRefine(const ProblemDomain& a_baseDomain,
                        const int a_blockFactor,
                        const int a_bufferSize,
                        const int a_maxBoxSize)
-  :m_granularity(1)
+  :m_granularity(1), m_distributedClustering(false)
 {
   define(a_baseDomain, a_refRatios, a_fillRatio, a_blockFactor,
          a_bufferSize, a_maxBoxSize);
@@ -393,6 +394,11 @@ void MeshRefine::setPNDMode(int a_mode)
   m_PNDMode = a_mode;
 }
 
+void MeshRefine::setDistributedClustering(bool a_distributed)
+{
+  m_distributedClustering = a_distributed;
+}
+
 //
 // This regrid function takes a single IntVectSet of tags
 //
@@ -595,32 +601,37 @@ MeshRefine::regrid(Vector<Vector<Box> >&   a_newmeshes,
           {
             // make a new mesh at the same level as the tags
 
-            const int dest_proc = uniqueProc(SerialTask::compute);
+            // In distributed clustering mode each rank keeps its own tags
+            // and makeBoxes merges the boxes afterward.
+            if (!m_distributedClustering)
+              {
+                const int dest_proc = uniqueProc(SerialTask::compute);
 
-            Vector<IntVectSet> all_tags;
-            gather(all_tags, modifiedTags[lvl], dest_proc);
+                Vector<IntVectSet> all_tags;
+                gather(all_tags, modifiedTags[lvl], dest_proc);
 
-            if (procID() == dest_proc)
-              {
-                for (int i = 0; i < all_tags.size(); ++i)
+                if (procID() == dest_proc)
                   {
-                     modifiedTags[lvl] |= all_tags[i];
-                    //**FIXME -- revert to above line when IVS is fixed.
-                    //**The following works around a bug in IVS that appears if
-                    //**the above line is used.  This bug is observed when there
-                    //**is a coarsening of an IVS containing only IntVect::Zero
-                    //**followed by an IVS |= IVS.
-                   // for (IVSIterator ivsit(all_tags[i]); ivsit.ok(); ++ivsit)
-                   //   {
-                   //     modifiedTags[lvl] |= ivsit();
-                   //   }
-                    //**FIXME -- hopefully fixed (BVS 10/30/2015)
-                    // Regain memory used (BVS,NDK 6/30/2008)
-                    all_tags[i].makeEmpty();
+                    for (int i = 0; i < all_tags.size(); ++i)
+                      {
+                         modifiedTags[lvl] |= all_tags[i];
+                        //**FIXME -- revert to above line when IVS is fixed.
+                        //**The following works around a bug in IVS that appears if
+                        //**the above line is used.  This bug is observed when there
+                        //**is a coarsening of an IVS containing only IntVect::Zero
+                        //**followed by an IVS |= IVS.
+                       // for (IVSIterator ivsit(all_tags[i]); ivsit.ok(); ++ivsit)
+                       //   {
+                       //     modifiedTags[lvl] |= ivsit();
+                       //   }
+                        //**FIXME -- hopefully fixed (BVS 10/30/2015)
+                        // Regain memory used (BVS,NDK 6/30/2008)
+                        all_tags[i].makeEmpty();
+                      }
                   }
-              }
 
-            broadcast( modifiedTags[lvl] , dest_proc);
+                broadcast( modifiedTags[lvl] , dest_proc);
+              }
 
             // Move this union _after_ the above gather/broadcast to
             // reduce memory -- shouldn't have other effects. (BVS,NDK 6/30/2008)
@@ -634,7 +645,21 @@ MeshRefine::regrid(Vector<Vector<Box> >&   a_newmeshes,
             // this is simple in the non-periodic case, more complicated
             // in the periodic case
             ProblemDomain lvldomain = Domains[lvl]; // domain of this level
-            buildSupport(lvldomain, lvlboxes, modifiedTags[lvl]);
+            if (m_distributedClustering)
+              {
+                // every rank has all of lvlboxes, but each box only needs
+                // to be added to the tags of one of them
+                Vector<Box> myboxes;
+                for (int ibox = procID(); ibox < lvlboxes.size(); ibox += numProc())
+                  {
+                    myboxes.push_back(lvlboxes[ibox]);
+                  }
+                buildSupport(lvldomain, myboxes, modifiedTags[lvl]);
+              }
+            else
+              {
+                buildSupport(lvldomain, lvlboxes, modifiedTags[lvl]);
+              }
 
             // this is the maximum allowable box size at this resolution
             // which will result in satisfying the maxSize restriction when
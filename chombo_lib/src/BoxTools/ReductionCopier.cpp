@@ -987,6 +987,7 @@ void ReductionCopier::reverse()
       m_toMotionPlan[i]->reverse();
     }
   m_fromMotionPlan.swap(m_toMotionPlan);
+  invalidateLocalGroups();
 }
 
 int ReductionCopier::print() const
@@ -0,0 +1,863 @@
+#ifdef CH_LANG_CC
+/*
+ *      _______              __
+ *     / ___/ /  ___  __ _  / /  ___
+ *    / /__/ _ \/ _ \/  V \/ _ \/ _ \
+ *    \___/_//_/\___/_/_/_/_.__/\___/
+ *    Please refer to Copyright.txt, in Chombo's root directory.
+ */
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include "RunIntVectSet.H"
+#include "DenseIntVectSet.H"
+#include "TreeIntVectSet.H"
+#include "BoxIterator.H"
+#include "NamespaceHeader.H"
+
+// floor(a_i/a_ref), also for negative a_i
+static inline int coarsenIndex(int a_i, int a_ref)
+{
+  return (a_i < 0) ? -1 - (-1 - a_i)/a_ref : a_i/a_ref;
+}
+
+RunIntVectSet::RunIntVectSet()
+  :m_minBoxCurrent(true)
+{
+}
+
+RunIntVectSet::RunIntVectSet(const Box& a_box)
+{
+  define(a_box);
+}
+
+RunIntVectSet::RunIntVectSet(const DenseIntVectSet& a_dense)
+{
+  define(a_dense);
+}
+
+RunIntVectSet::RunIntVectSet(const TreeIntVectSet& a_tree, const Box& a_clip)
+{
+  define(a_tree, a_clip);
+}
+
+void RunIntVectSet::define(const Box& a_box)
+{
+  clear();
+  appendBox(m_runs, a_box);
+  m_minBox = a_box;
+}
+
+void RunIntVectSet::define(const DenseIntVectSet& a_dense)
+{
+  clear();
+  if (a_dense.isEmpty()) return;
+  if (a_dense.isFull())
+    {
+      appendBox(m_runs, a_dense.box());
+      m_minBoxCurrent = false;
+      return;
+    }
+  // bits come in BoxIterator order, so these all append to the last run
+  DenseIntVectSetIterator it(a_dense);
+  for (it.begin(); it.ok(); ++it)
+    {
+      *this |= it();
+    }
+}
+
+void RunIntVectSet::define(const TreeIntVectSet& a_tree, const Box& a_clip)
+{
+  clear();
+  Vector<Box> boxes = a_tree.createBoxes();
+  for (int ibox = 0; ibox < boxes.size(); ibox++)
+    {
+      appendBox(m_runs, boxes[ibox] & a_clip);
+    }
+  coalesce(m_runs, true);
+  m_minBoxCurrent = false;
+}
+
+void RunIntVectSet::clear()
+{
+  m_runs.clear();
+  m_pending.clear();
+  m_minBox = Box();
+  m_minBoxCurrent = true;
+}
+
+void RunIntVectSet::coalesce(std::vector<Run>& a_runs, bool a_sort)
+{
+  if (a_sort)
+    {
+      std::sort(a_runs.begin(), a_runs.end());
+    }
+  if (a_runs.size() == 0) return;
+  size_t n = 0;
+  for (size_t i = 1; i < a_runs.size(); i++)
+    {
+      Run& last = a_runs[n];
+      const Run& run = a_runs[i];
+      if ((compareRows(last.m_lo, run.m_lo) == 0) && (run.m_lo[0] <= last.m_hi + 1))
+        {
+          if (run.m_hi > last.m_hi) last.m_hi = run.m_hi;
+        }
+      else
+        {
+          n++;
+          a_runs[n] = run;
+        }
+    }
+  a_runs.resize(n+1);
+}
+
+void RunIntVectSet::appendBox(std::vector<Run>& a_runs, const Box& a_box)
+{
+  if (a_box.isEmpty()) return;
+  IntVect rowsHi = a_box.bigEnd();
+  rowsHi[0] = a_box.smallEnd(0);
+  Box rows(a_box.smallEnd(), rowsHi);
+  Run run;
+  run.m_hi = a_box.bigEnd(0);
+  for (BoxIterator bit(rows); bit.ok(); ++bit)
+    {
+      run.m_lo = bit();
+      a_runs.push_back(run);
+    }
+}
+
+void RunIntVectSet::unionRuns(std::vector<Run>& a_runs, const std::vector<Run>& a_other)
+{
+  if (a_other.size() == 0) return;
+  if (a_runs.size() == 0)
+    {
+      a_runs = a_other;
+      return;
+    }
+  std::vector<Run> merged(a_runs.size() + a_other.size());
+  std::merge(a_runs.begin(), a_runs.end(), a_other.begin(), a_other.end(), merged.begin());
+  coalesce(merged, false);
+  a_runs.swap(merged);
+}
+
+void RunIntVectSet::intersectRuns(std::vector<Run>& a_runs, const std::vector<Run>& a_other)
+{
+  std::vector<Run> result;
+  size_t i = 0;
+  size_t j = 0;
+  while ((i < a_runs.size()) && (j < a_other.size()))
+    {
+      const Run& r1 = a_runs[i];
+      const Run& r2 = a_other[j];
+      int c = compareRows(r1.m_lo, r2.m_lo);
+      if (c < 0)
+        {
+          i++;
+        }
+      else if (c > 0)
+        {
+          j++;
+        }
+      else
+        {
+          Run run;
+          run.m_lo    = r1.m_lo;
+          run.m_lo[0] = Max(r1.m_lo[0], r2.m_lo[0]);
+          run.m_hi    = Min(r1.m_hi, r2.m_hi);
+          if (run.m_lo[0] <= run.m_hi) result.push_back(run);
+          if (r1.m_hi < r2.m_hi) i++;
+          else                   j++;
+        }
+    }
+  a_runs.swap(result);
+}
+
+void RunIntVectSet::subtractRuns(std::vector<Run>& a_runs, const std::vector<Run>& a_other)
+{
+  if ((a_runs.size() == 0) || (a_other.size() == 0)) return;
+  std::vector<Run> result;
+  result.reserve(a_runs.size());
+  size_t j = 0;
+  for (size_t i = 0; i < a_runs.size(); i++)
+    {
+      Run run = a_runs[i];
+      // skip whatever is entirely before this run
+      while ((j < a_other.size()) &&
+             ((compareRows(a_other[j].m_lo, run.m_lo) < 0) ||
+              ((compareRows(a_other[j].m_lo, run.m_lo) == 0) && (a_other[j].m_hi < run.m_lo[0]))))
+        {
+          j++;
+        }
+      for (size_t k = j; k < a_other.size(); k++)
+        {
+          const Run& hole = a_other[k];
+          if ((compareRows(hole.m_lo, run.m_lo) != 0) || (hole.m_lo[0] > run.m_hi)) break;
+          if (hole.m_lo[0] > run.m_lo[0])
+            {
+              Run piece = run;
+              piece.m_hi = hole.m_lo[0] - 1;
+              result.push_back(piece);
+            }
+          run.m_lo[0] = Max(run.m_lo[0], hole.m_hi + 1);
+          if (run.m_lo[0] > run.m_hi) break;
+        }
+      if (run.m_lo[0] <= run.m_hi) result.push_back(run);
+    }
+  a_runs.swap(result);
+}
+
+void RunIntVectSet::shiftedRuns(std::vector<Run>& a_runs, const IntVect& a_iv) const
+{
+  a_runs = m_runs;
+  for (size_t i = 0; i < a_runs.size(); i++)
+    {
+      a_runs[i].m_lo += a_iv;
+      a_runs[i].m_hi += a_iv[0];
+    }
+}
+
+void RunIntVectSet::normalize() const
+{
+  if (m_pending.size() == 0) return;
+  coalesce(m_pending, true);
+  unionRuns(m_runs, m_pending);
+  m_pending.clear();
+}
+
+RunIntVectSet& RunIntVectSet::operator|=(const IntVect& a_iv)
+{
+  if (m_minBoxCurrent)
+    {
+      if (m_minBox.isEmpty()) m_minBox = Box(a_iv, a_iv);
+      else                    m_minBox.minBox(Box(a_iv, a_iv));
+    }
+
+  // the usual case is cells arriving in BoxIterator order, which either
+  // extend the last run or start a new one after it
+  std::vector<Run>& runs = (m_pending.size() == 0) ? m_runs : m_pending;
+  if (runs.size() > 0)
+    {
+      Run& last = runs.back();
+      int c = compareRows(a_iv, last.m_lo);
+      if ((c == 0) && (a_iv[0] >= last.m_lo[0]) && (a_iv[0] <= last.m_hi + 1))
+        {
+          if (a_iv[0] == last.m_hi + 1) last.m_hi++;
+          return *this;
+        }
+      if ((m_pending.size() == 0) && (c < 0 || (c == 0 && a_iv[0] < last.m_lo[0])))
+        {
+          // out of order: buffer it
+          if (contains(a_iv)) return *this;
+          Run run;
+          run.m_lo = a_iv;
+          run.m_hi = a_iv[0];
+          m_pending.push_back(run);
+          return *this;
+        }
+    }
+  Run run;
+  run.m_lo = a_iv;
+  run.m_hi = a_iv[0];
+  runs.push_back(run);
+  if ((int)m_pending.size() > s_maxPending) normalize();
+  return *this;
+}
+
+RunIntVectSet& RunIntVectSet::operator|=(const Box& a_box)
+{
+  if (a_box.isEmpty()) return *this;
+  normalize();
+  if (m_minBoxCurrent)
+    {
+      if (m_minBox.isEmpty()) m_minBox = a_box;
+      else                    m_minBox.minBox(a_box);
+    }
+  std::vector<Run> boxRuns;
+  appendBox(boxRuns, a_box);
+  unionRuns(m_runs, boxRuns);
+  return *this;
+}
+
+RunIntVectSet& RunIntVectSet::operator|=(const RunIntVectSet& a_ivs)
+{
+  if (&a_ivs == this) return *this;
+  normalize();
+  a_ivs.normalize();
+  if (a_ivs.m_runs.size() == 0) return *this;
+  unionRuns(m_runs, a_ivs.m_runs);
+  m_minBoxCurrent = false;
+  return *this;
+}
+
+RunIntVectSet& RunIntVectSet::operator-=(const IntVect& a_iv)
+{
+  normalize();
+  Run key;
+  key.m_lo = a_iv;
+  key.m_hi = a_iv[0];
+  std::vector<Run>::iterator it = std::upper_bound(m_runs.begin(), m_runs.end(), key);
+  if (it == m_runs.begin()) return *this;
+  --it;
+  if ((compareRows(it->m_lo, a_iv) != 0) || (it->m_hi < a_iv[0])) return *this;
+
+  m_minBoxCurrent = false;
+  if (it->m_lo[0] == it->m_hi)
+    {
+      m_runs.erase(it);
+    }
+  else if (it->m_lo[0] == a_iv[0])
+    {
+      it->m_lo[0]++;
+    }
+  else if (it->m_hi == a_iv[0])
+    {
+      it->m_hi--;
+    }
+  else
+    {
+      Run hi = *it;
+      hi.m_lo[0] = a_iv[0] + 1;
+      it->m_hi   = a_iv[0] - 1;
+      m_runs.insert(it+1, hi);
+    }
+  return *this;
+}
+
+RunIntVectSet& RunIntVectSet::operator-=(const Box& a_box)
+{
+  if (a_box.isEmpty()) return *this;
+  normalize();
+  std::vector<Run> result;
+  result.reserve(m_runs.size());
+  const IntVect& lo = a_box.smallEnd();
+  const IntVect& hi = a_box.bigEnd();
+  for (size_t i = 0; i < m_runs.size(); i++)
+    {
+      const Run& run = m_runs[i];
+      bool inRows = true;
+      for (int idir = 1; idir < SpaceDim; idir++)
+        {
+          inRows = inRows && (run.m_lo[idir] >= lo[idir]) && (run.m_lo[idir] <= hi[idir]);
+        }
+      if (!inRows || (run.m_hi < lo[0]) || (run.m_lo[0] > hi[0]))
+        {
+          result.push_back(run);
+          continue;
+        }
+      if (run.m_lo[0] < lo[0])
+        {
+          Run piece = run;
+          piece.m_hi = lo[0] - 1;
+          result.push_back(piece);
+        }
+      if (run.m_hi > hi[0])
+        {
+          Run piece = run;
+          piece.m_lo[0] = hi[0] + 1;
+          result.push_back(piece);
+        }
+    }
+  m_runs.swap(result);
+  m_minBoxCurrent = false;
+  return *this;
+}
+
+RunIntVectSet& RunIntVectSet::operator-=(const RunIntVectSet& a_ivs)
+{
+  if (&a_ivs == this)
+    {
+      clear();
+      return *this;
+    }
+  normalize();
+  a_ivs.normalize();
+  subtractRuns(m_runs, a_ivs.m_runs);
+  m_minBoxCurrent = false;
+  return *this;
+}
+
+RunIntVectSet& RunIntVectSet::operator&=(const Box& a_box)
+{
+  normalize();
+  std::vector<Run> result;
+  const IntVect& lo = a_box.smallEnd();
+  const IntVect& hi = a_box.bigEnd();
+  if (!a_box.isEmpty())
+    {
+      for (size_t i = 0; i < m_runs.size(); i++)
+        {
+          Run run = m_runs[i];
+          bool inRows = true;
+          for (int idir = 1; idir < SpaceDim; idir++)
+            {
+              inRows = inRows && (run.m_lo[idir] >= lo[idir]) && (run.m_lo[idir] <= hi[idir]);
+            }
+          if (!inRows) continue;
+          run.m_lo[0] = Max(run.m_lo[0], lo[0]);
+          run.m_hi    = Min(run.m_hi, hi[0]);
+          if (run.m_lo[0] <= run.m_hi) result.push_back(run);
+        }
+    }
+  m_runs.swap(result);
+  m_minBoxCurrent = false;
+  return *this;
+}
+
+RunIntVectSet& RunIntVectSet::operator&=(const ProblemDomain& a_domain)
+{
+  if (isEmpty()) return *this;
+  const Box& minbox = minBox();
+  if (a_domain.domainBox().contains(minbox)) return *this;
+
+  IntVect chopSml = a_domain.domainBox().smallEnd();
+  IntVect chopBig = a_domain.domainBox().bigEnd();
+  for (int idir = 0; idir < SpaceDim; idir++)
+    {
+      if (a_domain.isPeriodic(idir))
+        {
+          chopSml[idir] = minbox.smallEnd(idir);
+          chopBig[idir] = minbox.bigEnd(idir);
+        }
+    }
+  *this &= Box(chopSml, chopBig);
+  return *this;
+}
+
+RunIntVectSet& RunIntVectSet::operator&=(const RunIntVectSet& a_ivs)
+{
+  if (&a_ivs == this) return *this;
+  normalize();
+  a_ivs.normalize();
+  intersectRuns(m_runs, a_ivs.m_runs);
+  m_minBoxCurrent = false;
+  return *this;
+}
+
+void RunIntVectSet::grow(int a_igrow)
+{
+  for (int idir = 0; idir < SpaceDim; idir++)
+    {
+      grow(idir, a_igrow);
+    }
+}
+
+void RunIntVectSet::grow(int a_idir, int a_igrow)
+{
+  CH_assert(a_idir >= 0);
+  CH_assert(a_idir < SpaceDim);
+  if (a_igrow == 0) return;
+  normalize();
+  m_minBoxCurrent = false;
+  if (a_igrow > 0)
+    {
+      if (a_idir == 0)
+        {
+          for (size_t i = 0; i < m_runs.size(); i++)
+            {
+              m_runs[i].m_lo[0] -= a_igrow;
+              m_runs[i].m_hi    += a_igrow;
+            }
+          coalesce(m_runs, false);
+        }
+      else
+        {
+          std::vector<Run> grown;
+          grown.reserve((2*a_igrow + 1)*m_runs.size());
+          for (int ishift = -a_igrow; ishift <= a_igrow; ishift++)
+            {
+              for (size_t i = 0; i < m_runs.size(); i++)
+                {
+                  Run run = m_runs[i];
+                  run.m_lo[a_idir] += ishift;
+                  grown.push_back(run);
+                }
+            }
+          coalesce(grown, true);
+          m_runs.swap(grown);
+        }
+    }
+  else
+    {
+      // same as DenseIntVectSet: intersect with the set shifted both ways
+      IntVect shiftvec = a_igrow*BASISV(a_idir);
+      std::vector<Run> shiftPlus;
+      std::vector<Run> shiftMinu;
+      shiftedRuns(shiftPlus,  shiftvec);
+      shiftedRuns(shiftMinu, -shiftvec);
+      intersectRuns(m_runs, shiftPlus);
+      intersectRuns(m_runs, shiftMinu);
+    }
+}
+
+void RunIntVectSet::growHi()
+{
+  for (int idir = 0; idir < SpaceDim; idir++)
+    {
+      growHi(idir);
+    }
+}
+
+void RunIntVectSet::growHi(int a_dir)
+{
+  CH_assert(a_dir >= 0);
+  CH_assert(a_dir < SpaceDim);
+  normalize();
+  if (a_dir == 0)
+    {
+      for (size_t i = 0; i < m_runs.size(); i++)
+        {
+          m_runs[i].m_hi++;
+        }
+      coalesce(m_runs, false);
+    }
+  else
+    {
+      std::vector<Run> shifted;
+      shiftedRuns(shifted, BASISV(a_dir));
+      unionRuns(m_runs, shifted);
+    }
+  m_minBoxCurrent = false;
+}
+
+void RunIntVectSet::refine(int a_iref)
+{
+  CH_assert(a_iref >= 1);
+  if (a_iref == 1) return;
+  normalize();
+  // the fine rows under one coarse row
+  Box offsets(IntVect::Zero, (a_iref-1)*(IntVect::Unit - BASISV(0)));
+  std::vector<Run> fine;
+  fine.reserve(offsets.numPts()*m_runs.size());
+  for (size_t i = 0; i < m_runs.size(); i++)
+    {
+      Run run;
+      run.m_hi = m_runs[i].m_hi*a_iref + a_iref - 1;
+      for (BoxIterator bit(offsets); bit.ok(); ++bit)
+        {
+          run.m_lo = m_runs[i].m_lo*a_iref + bit();
+          fine.push_back(run);
+        }
+    }
+  coalesce(fine, true);
+  m_runs.swap(fine);
+  m_minBoxCurrent = false;
+}
+
+void RunIntVectSet::coarsen(int a_iref)
+{
+  CH_assert(a_iref >= 1);
+  if (a_iref == 1) return;
+  normalize();
+  for (size_t i = 0; i < m_runs.size(); i++)
+    {
+      m_runs[i].m_lo = CH_XD::coarsen(m_runs[i].m_lo, a_iref);
+      m_runs[i].m_hi = coarsenIndex(m_runs[i].m_hi, a_iref);
+    }
+  coalesce(m_runs, true);
+  m_minBoxCurrent = false;
+}
+
+void RunIntVectSet::shift(const IntVect& a_iv)
+{
+  for (size_t i = 0; i < m_runs.size(); i++)
+    {
+      m_runs[i].m_lo += a_iv;
+      m_runs[i].m_hi += a_iv[0];
+    }
+  for (size_t i = 0; i < m_pending.size(); i++)
+    {
+      m_pending[i].m_lo += a_iv;
+      m_pending[i].m_hi += a_iv[0];
+    }
+  if (m_minBoxCurrent && !m_minBox.isEmpty()) m_minBox.shift(a_iv);
+}
+
+RunIntVectSet RunIntVectSet::chop(int a_dir, int a_chop_pnt)
+{
+  CH_assert(a_dir >= 0);
+  CH_assert(a_dir < SpaceDim);
+  normalize();
+  RunIntVectSet rtn;
+  std::vector<Run> lo;
+  std::vector<Run>& hi = rtn.m_runs;
+  for (size_t i = 0; i < m_runs.size(); i++)
+    {
+      const Run& run = m_runs[i];
+      if (a_dir == 0)
+        {
+          if (run.m_hi < a_chop_pnt)
+            {
+              lo.push_back(run);
+            }
+          else if (run.m_lo[0] >= a_chop_pnt)
+            {
+              hi.push_back(run);
+            }
+          else
+            {
+              Run piece = run;
+              piece.m_hi = a_chop_pnt - 1;
+              lo.push_back(piece);
+              piece.m_lo[0] = a_chop_pnt;
+              piece.m_hi    = run.m_hi;
+              hi.push_back(piece);
+            }
+        }
+      else if (run.m_lo[a_dir] < a_chop_pnt)
+        {
+          lo.push_back(run);
+        }
+      else
+        {
+          hi.push_back(run);
+        }
+    }
+  m_runs.swap(lo);
+  m_minBoxCurrent = false;
+  rtn.m_minBoxCurrent = false;
+  return rtn;
+}
+
+bool RunIntVectSet::contains(const IntVect& a_iv) const
+{
+  Run key;
+  key.m_lo = a_iv;
+  key.m_hi = a_iv[0];
+  std::vector<Run>::const_iterator it = std::upper_bound(m_runs.begin(), m_runs.end(), key);
+  if (it != m_runs.begin())
+    {
+      --it;
+      if ((compareRows(it->m_lo, a_iv) == 0) && (it->m_hi >= a_iv[0])) return true;
+    }
+  // the buffer is short and unsorted
+  for (size_t i = 0; i < m_pending.size(); i++)
+    {
+      const Run& run = m_pending[i];
+      if ((compareRows(run.m_lo, a_iv) == 0) &&
+          (run.m_lo[0] <= a_iv[0]) && (run.m_hi >= a_iv[0])) return true;
+    }
+  return false;
+}
+
+bool RunIntVectSet::contains(const Box& a_box) const
+{
+  if (a_box.isEmpty()) return true;
+  normalize();
+  IntVect rowsHi = a_box.bigEnd();
+  rowsHi[0] = a_box.smallEnd(0);
+  Box rows(a_box.smallEnd(), rowsHi);
+  for (BoxIterator bit(rows); bit.ok(); ++bit)
+    {
+      Run key;
+      key.m_lo = bit();
+      key.m_hi = key.m_lo[0];
+      std::vector<Run>::const_iterator it = std::upper_bound(m_runs.begin(), m_runs.end(), key);
+      if (it == m_runs.begin()) return false;
+      --it;
+      if ((compareRows(it->m_lo, key.m_lo) != 0) || (it->m_hi < a_box.bigEnd(0))) return false;
+    }
+  return true;
+}
+
+bool RunIntVectSet::isEmpty() const
+{
+  return (m_runs.size() == 0) && (m_pending.size() == 0);
+}
+
+int RunIntVectSet::numPts() const
+{
+  normalize();
+  int numPts = 0;
+  for (size_t i = 0; i < m_runs.size(); i++)
+    {
+      numPts += m_runs[i].m_hi - m_runs[i].m_lo[0] + 1;
+    }
+  return numPts;
+}
+
+int RunIntVectSet::numRuns() const
+{
+  normalize();
+  return m_runs.size();
+}
+
+long long RunIntVectSet::memory() const
+{
+  return (long long)(m_runs.capacity() + m_pending.capacity())*sizeof(Run);
+}
+
+const Box& RunIntVectSet::minBox() const
+{
+  normalize();
+  if (!m_minBoxCurrent)
+    {
+      if (m_runs.size() == 0)
+        {
+          m_minBox = Box();
+        }
+      else
+        {
+          IntVect lo = m_runs[0].m_lo;
+          IntVect hi = m_runs[0].m_lo;
+          hi[0] = m_runs[0].m_hi;
+          for (size_t i = 1; i < m_runs.size(); i++)
+            {
+              lo.min(m_runs[i].m_lo);
+              hi.max(m_runs[i].m_lo);
+              lo[0] = Min(lo[0], m_runs[i].m_lo[0]);
+              hi[0] = Max(hi[0], m_runs[i].m_hi);
+            }
+          m_minBox = Box(lo, hi);
+        }
+      m_minBoxCurrent = true;
+    }
+  return m_minBox;
+}
+
+Vector<Box> RunIntVectSet::createBoxes() const
+{
+  normalize();
+  Vector<Box> boxes(m_runs.size());
+  for (size_t i = 0; i < m_runs.size(); i++)
+    {
+      IntVect hi = m_runs[i].m_lo;
+      hi[0] = m_runs[i].m_hi;
+      boxes[i] = Box(m_runs[i].m_lo, hi);
+    }
+  return boxes;
+}
+
+void RunIntVectSet::makeTraces(Vector<int>* a_traces, const Box& a_minBox) const
+{
+  normalize();
+  for (int idir = 0; idir < SpaceDim; idir++)
+    {
+      a_traces[idir].resize(0);
+      a_traces[idir].resize(a_minBox.isEmpty() ? 0 : a_minBox.size(idir), 0);
+    }
+  const IntVect& offset = a_minBox.smallEnd();
+  for (size_t i = 0; i < m_runs.size(); i++)
+    {
+      const Run& run = m_runs[i];
+      CH_assert(a_minBox.contains(run.m_lo));
+      for (int ix = run.m_lo[0]; ix <= run.m_hi; ix++)
+        {
+          a_traces[0][ix - offset[0]]++;
+        }
+      int length = run.m_hi - run.m_lo[0] + 1;
+      for (int idir = 1; idir < SpaceDim; idir++)
+        {
+          a_traces[idir][run.m_lo[idir] - offset[idir]] += length;
+        }
+    }
+}
+
+void RunIntVectSet::compact() const
+{
+  normalize();
+  std::vector<Run>(m_runs).swap(m_runs);
+  std::vector<Run>().swap(m_pending);
+}
+
+int RunIntVectSet::linearSize() const
+{
+  normalize();
+  return (1 + m_runs.size()*(SpaceDim+1))*sizeof(int);
+}
+
+void RunIntVectSet::linearIn(const void* const a_inBuf)
+{
+  clear();
+  const int* buf = (const int*)a_inBuf;
+  int numRuns = *buf++;
+  m_runs.resize(numRuns);
+  for (int i = 0; i < numRuns; i++)
+    {
+      for (int idir = 0; idir < SpaceDim; idir++)
+        {
+          m_runs[i].m_lo[idir] = *buf++;
+        }
+      m_runs[i].m_hi = *buf++;
+    }
+  m_minBoxCurrent = false;
+}
+
+void RunIntVectSet::linearOut(void* const a_outBuf) const
+{
+  normalize();
+  int* buf = (int*)a_outBuf;
+  *buf++ = m_runs.size();
+  for (size_t i = 0; i < m_runs.size(); i++)
+    {
+      for (int idir = 0; idir < SpaceDim; idir++)
+        {
+          *buf++ = m_runs[i].m_lo[idir];
+        }
+      *buf++ = m_runs[i].m_hi;
+    }
+}
+
+bool RunIntVectSet::operator==(const RunIntVectSet& a_ivs) const
+{
+  normalize();
+  a_ivs.normalize();
+  if (m_runs.size() != a_ivs.m_runs.size()) return false;
+  for (size_t i = 0; i < m_runs.size(); i++)
+    {
+      if ((m_runs[i].m_lo != a_ivs.m_runs[i].m_lo) ||
+          (m_runs[i].m_hi != a_ivs.m_runs[i].m_hi)) return false;
+    }
+  return true;
+}
+
+bool RunIntVectSet::operator<(const RunIntVectSet& a_ivs) const
+{
+  normalize();
+  a_ivs.normalize();
+  if (m_runs.size() != a_ivs.m_runs.size())
+    {
+      return m_runs.size() < a_ivs.m_runs.size();
+    }
+  for (size_t i = 0; i < m_runs.size(); i++)
+    {
+      const Run& r1 = m_runs[i];
+      const Run& r2 = a_ivs.m_runs[i];
+      if (r1 < r2) return true;
+      if (r2 < r1) return false;
+      if (r1.m_hi != r2.m_hi) return r1.m_hi < r2.m_hi;
+    }
+  return false;
+}
+
+//====================================================================
+RunIntVectSetIterator::RunIntVectSetIterator()
+  :m_ivsPtr(NULL),
+   m_index(0)
+{
+}
+
+RunIntVectSetIterator::RunIntVectSetIterator(const RunIntVectSet& a_ivs)
+{
+  define(a_ivs);
+}
+
+void RunIntVectSetIterator::define(const RunIntVectSet& a_ivs)
+{
+  m_ivsPtr = &a_ivs;
+  a_ivs.normalize();
+  begin();
+}
+
+void RunIntVectSetIterator::begin()
+{
+  m_index = 0;
+  if (ok()) m_current = m_ivsPtr->m_runs[0].m_lo;
+}
+
+void RunIntVectSetIterator::end()
+{
+  if (m_ivsPtr != NULL) m_index = m_ivsPtr->m_runs.size();
+}
+
+#include "NamespaceFooter.H"
@@ -961,6 +961,7 @@ void SpreadingCopier::reverse()
       m_toMotionPlan[i]->reverse();
     }
   m_fromMotionPlan.swap(m_toMotionPlan);
+  invalidateLocalGroups();
 }
 
 int SpreadingCopier::print() const
@@ -15,6 +15,7 @@
 #endif
 
 #include "LoadBalance.H"
+#include "TimedDataIterator.H"
 #include "EBEllipticLoadBalance.H"
 #include "EBArith.H"
 #include "BRMeshRefine.H"
@@ -28,6 +29,7 @@
 #include "BCFunc.H"
 #include "AMRPoissonOpF_F.H"
 #include "CH_Timer.H"
+#include "ClockTicks.H"
 #include "BCFunc.H"
 #include "EBLevelGrid.H"
 #include "EBAlias.H"
@@ -99,6 +101,10 @@ EBAMRPoissonOp::~EBAMRPoissonOp()
 
 EBAMRPoissonOp::EBAMRPoissonOp()
 {
+  m_agglomeratedProc = -1;
+#ifdef CH_MPI
+  m_comm = Chombo_MPI::comm;
+#endif
 }
 
 //////////////
@@ -125,17 +131,25 @@ EBAMRPoissonOp(const EBLevelGrid &                  a_eblgFine,
                const Real&                          a_beta,
                const IntVect&                       a_ghostCellsPhi,
                const IntVect&                       a_ghostCellsRHS,
-               int                                  a_testRef)
+               int                                  a_testRef,
+               int                                  a_ncomp)
 : m_testRef( a_testRef ),
   m_ghostCellsPhi( a_ghostCellsPhi ),
   m_ghostCellsRHS( a_ghostCellsRHS )
 {
   CH_TIME("EBAMRPoissonOp::EBAMRPoissonOp");
+  CH_assert(a_ncomp >= 1);
+  m_ncomp          = a_ncomp;
   m_quadCFIWithCoar = a_quadCFI;
   m_hasFine        = a_hasFine;
   m_hasCoar        = a_hasCoar;
   m_numPreCondIters= a_numPreCondIters;
   m_relaxType      = a_relaxType;
+  //the slow and cloned relaxers only know about one component
+  if ((m_ncomp != 1) && (m_relaxType != 1) && (m_relaxType != 2) && (m_relaxType != 999))
+    {
+      MayDay::Error("EBAMRPoissonOp: only relaxType 1, 2 or 999 can relax more than one component");
+    }
   m_eblg            = a_eblg;
   m_domainBC       = a_domainBC;
   m_ebBC           = a_ebBC;
@@ -149,6 +163,10 @@ EBAMRPoissonOp(const EBLevelGrid &                  a_eblgFine,
   m_dxCoar         = a_dxCoar;
   m_hasMGObjects = a_hasMGObjects;
   m_layoutChanged = a_layoutChanged;
+  m_agglomeratedProc = getAgglomeratedProc(m_eblg.getDBL());
+#ifdef CH_MPI
+  m_comm = Chombo_MPI::comm;
+#endif
 
   //pre-compute 1/dx and 1/(dx^2)
   m_invDx  = 1.0/m_dx;
@@ -173,7 +191,7 @@ EBAMRPoissonOp(const EBLevelGrid &                  a_eblgFine,
     }
 
   EBCellFactory ebcellfactTL(m_eblg.getEBISL());
-  m_resThisLevel.define(m_eblg.getDBL(), 1, m_ghostCellsRHS, ebcellfactTL);
+  m_resThisLevel.define(m_eblg.getDBL(), m_ncomp, m_ghostCellsRHS, ebcellfactTL);
 
   //define stencils for the operator
   defineStencils();
@@ -191,7 +209,7 @@ defineMGObjects(const EBLevelGrid& a_eblgCoarMG)
   if (m_hasMGObjects)
     {
       int mgRef = 2;
-      int ncomp =1 ;
+      int ncomp = m_ncomp;
       m_eblgCoarMG = a_eblgCoarMG;
 
       m_ebInterpMG.define( m_eblg.getDBL(),     m_eblgCoarMG.getDBL(),
@@ -213,7 +231,7 @@ defineWithCoarser(const EBLevelGrid& a_eblgCoar, const int& a_refToCoar)
 {
   if (m_hasCoar)
     {
-      int ncomp = 1;
+      int ncomp = m_ncomp;
       m_eblgCoar       = a_eblgCoar;
       m_refToCoar      = a_refToCoar   ;
 
@@ -281,7 +299,7 @@ defineWithFiner(const EBLevelGrid& a_eblgFine,
 {
   if (m_hasFine)
     {
-      int ncomp = 1;
+      int ncomp = m_ncomp;
       m_dxFine         = m_dx/a_refToFine;
       m_refToFine      = a_refToFine;
       m_eblgFine       = a_eblgFine;
@@ -403,6 +421,12 @@ defineStencils()
   Box sideBoxLo[SpaceDim];
   Box sideBoxHi[SpaceDim];
 
+  //either several single-component systems share this operator (s_numComps)
+  //or this operator solves one coupled system with m_ncomp components
+  if ((s_numComps != 1) && (m_ncomp != 1))
+    {
+      MayDay::Error("EBAMRPoissonOp: s_numComps and ncomp cannot both be greater than one");
+    }
   m_cacheInhomDomBCLo.resize(s_numComps);
   m_cacheInhomDomBCHi.resize(s_numComps);
   for (int icomp = 0; icomp < s_numComps; icomp++)
@@ -470,8 +494,8 @@ defineStencils()
 
           for (int icomp = 0; icomp < s_numComps; icomp++)
             {
-              (*m_cacheInhomDomBCLo[icomp][idir])[dit()].define(curEBISBox,curBox,1);
-              (*m_cacheInhomDomBCHi[icomp][idir])[dit()].define(curEBISBox,curBox,1);
+              (*m_cacheInhomDomBCLo[icomp][idir])[dit()].define(curEBISBox,curBox,m_ncomp);
+              (*m_cacheInhomDomBCHi[icomp][idir])[dit()].define(curEBISBox,curBox,m_ncomp);
             }
         }
 
@@ -589,19 +613,22 @@ defineStencils()
 
               for (int icomp = 0; icomp < s_numComps; icomp++)
                 {
-                  Real flux;
-                  m_domainBC->getInhomFaceFlux(flux,
-                                               vof,
-                                               icomp,//comp
-                                               (*m_cacheInhomDomBCLo[icomp][idir])[dit()],
-                                               m_origin,
-                                               m_dx,
-                                               idir,
-                                               Side::Lo,
-                                               dit(),
-                                               s_time);
-
-                  (*m_cacheInhomDomBCLo[icomp][idir])[dit()](vof, 0) = flux;
+                  for (int ivar = 0; ivar < m_ncomp; ivar++)
+                    {
+                      Real flux;
+                      m_domainBC->getInhomFaceFlux(flux,
+                                                   vof,
+                                                   icomp + ivar,//comp
+                                                   (*m_cacheInhomDomBCLo[icomp][idir])[dit()],
+                                                   m_origin,
+                                                   m_dx,
+                                                   idir,
+                                                   Side::Lo,
+                                                   dit(),
+                                                   s_time);
+
+                      (*m_cacheInhomDomBCLo[icomp][idir])[dit()](vof, ivar) = flux;
+                    }
                 }
             }//vofitlo
 
@@ -628,19 +655,22 @@ defineStencils()
 
               for (int icomp = 0; icomp < s_numComps; icomp++)
                 {
-                  Real flux;
-                  m_domainBC->getInhomFaceFlux(flux,
-                                               vof,
-                                               icomp,//comp
-                                               (*m_cacheInhomDomBCHi[icomp][idir])[dit()],
-                                               m_origin,
-                                               m_dx,
-                                               idir,
-                                               Side::Hi,
-                                               dit(),
-                                               s_time);
-
-                  (*m_cacheInhomDomBCHi[icomp][idir])[dit()](vof, 0) = flux;
+                  for (int ivar = 0; ivar < m_ncomp; ivar++)
+                    {
+                      Real flux;
+                      m_domainBC->getInhomFaceFlux(flux,
+                                                   vof,
+                                                   icomp + ivar,//comp
+                                                   (*m_cacheInhomDomBCHi[icomp][idir])[dit()],
+                                                   m_origin,
+                                                   m_dx,
+                                                   idir,
+                                                   Side::Hi,
+                                                   dit(),
+                                                   s_time);
+
+                      (*m_cacheInhomDomBCHi[icomp][idir])[dit()](vof, ivar) = flux;
+                    }
                 }
             }//vofithi
         }//idir
@@ -909,10 +939,57 @@ getCoarserLayouts(DisjointBoxLayout&       a_dblCoar,
       return false;
     }
 
+  //gather small levels onto one processor for the bottom solve
+  int agglomerateCells = 0;
+  pp.query("mg_agglomerate_cells", agglomerateCells);
+  if ((numProc() > 1) && (agglomerateCells > 0) &&
+      (a_dblCoar.numCells() <= agglomerateCells) &&
+      (getOwnerProc(a_dblCoar) < 0))
+    {
+      Vector<Box> boxes;
+      for (LayoutIterator lit = a_dblCoar.layoutIterator(); lit.ok(); ++lit)
+        {
+          boxes.push_back(a_dblCoar[lit()]);
+        }
+      Vector<int> procs(boxes.size(), uniqueProc(SerialTask::compute));
+      a_dblCoar = DisjointBoxLayout(boxes, procs, a_domainCoar);
+      a_layoutChanged = true;
+    }
+
   //if we got here, then we have coarser stuff
   return true;
 }
 /***/
+int
+EBAMRPoissonOp::
+getAgglomeratedProc(const DisjointBoxLayout& a_dbl)
+{
+  //only layouts small enough for getCoarserLayouts to have gathered
+  int agglomerateCells = 0;
+  ParmParse pp;
+  pp.query("mg_agglomerate_cells", agglomerateCells);
+  if ((agglomerateCells <= 0) || (a_dbl.numCells() > agglomerateCells))
+    {
+      return -1;
+    }
+  return getOwnerProc(a_dbl);
+}
+/***/
+int
+EBAMRPoissonOp::
+getOwnerProc(const DisjointBoxLayout& a_dbl)
+{
+  if (numProc() == 1) return -1;
+  int proc = -1;
+  for (LayoutIterator lit = a_dbl.layoutIterator(); lit.ok(); ++lit)
+    {
+      int boxProc = a_dbl.procID(lit());
+      if ((proc >= 0) && (boxProc != proc)) return -1;
+      proc = boxProc;
+    }
+  return proc;
+}
+/***/
 void
 EBAMRPoissonOp::
 getAggregatedLayout(DisjointBoxLayout           & a_dblCoar,
@@ -1086,7 +1163,10 @@ setListValue(EBCellFAB& a_fab, const Vector<VolIndex>& a_setList, Real a_value)
   for (int i = 0; i < a_setList.size(); i++ )
     {
       const VolIndex& vol = a_setList[i];
-      a_fab(vol,0) = a_value;
+      for (int icomp = 0; icomp < a_fab.nComp(); icomp++)
+        {
+          a_fab(vol,icomp) = a_value;
+        }
     }
 }
 
@@ -1257,13 +1337,16 @@ getInvDiagRHS(LevelData<EBCellFAB>&       a_lhs,
     }
   scale = 1.0 / scale;
 
-  for (DataIterator dit = m_eblg.getDBL().dataIterator(); dit.ok(); ++dit)
+  DataIterator dit = m_eblg.getDBL().dataIterator();
+  int nbox = dit.size();
+#pragma omp parallel for schedule(runtime)
+  for (int mybox = 0; mybox < nbox; mybox++)
     {
       CH_START(t1);
-      Box dblBox( m_eblg.getDBL().get(dit()) );
-      EBCellFAB&                   lhs = a_lhs[dit()];
+      Box dblBox( m_eblg.getDBL().get(dit[mybox]) );
+      EBCellFAB&                   lhs = a_lhs[dit[mybox]];
       BaseFab<Real>& lhsFAB = lhs.getSingleValuedFAB();
-      const EBCellFAB&             rhs = a_rhs[dit()];
+      const EBCellFAB&             rhs = a_rhs[dit[mybox]];
       const BaseFab<Real>& rhsFAB = rhs.getSingleValuedFAB();
       int ncomps = lhs.nComp();
       CH_assert(ncomps == rhs.nComp());
@@ -1276,10 +1359,13 @@ getInvDiagRHS(LevelData<EBCellFAB>&       a_lhs,
       CH_STOP(t1);
 
       CH_START(t2);
-      const BaseIVFAB<Real>& curAlphaWeight = m_alphaDiagWeight[dit()];
-      const BaseIVFAB<Real>& curBetaWeight =  m_betaDiagWeight[dit()];
+      const BaseIVFAB<Real>& curAlphaWeight = m_alphaDiagWeight[dit[mybox]];
+      const BaseIVFAB<Real>& curBetaWeight =  m_betaDiagWeight[dit[mybox]];
 
-      m_invDiagEBStencil[dit]->apply(lhs, rhs, 1., m_alpha, curAlphaWeight, m_beta, curBetaWeight, 1., false);
+      for (int icomp = 0; icomp < ncomps; icomp++)
+        {
+          m_invDiagEBStencil[dit[mybox]]->apply(lhs, rhs, 1., m_alpha, curAlphaWeight, m_beta, curBetaWeight, 1., false, icomp);
+        }
       CH_STOP(t2);
     }
 }
@@ -1372,119 +1458,159 @@ applyOpNoCFBCs(LevelData<EBCellFAB>&                    a_opPhi,
                const LevelData<BaseIVFAB<Real> >* const a_ebFluxBCLD //only non null in multifluid
                )
 {
-  CH_TIMERS("EBAMRPoissonOp::applyOpNoCFBCs");
+  CH_TIME("EBAMRPoissonOp::applyOpNoCFBCs");
+
+  //a timed iterator measures each box as it is incremented so it
+  //has to be walked in order.  otherwise boxes are independent.
+  if (dynamic_cast<TimedDataIterator*>(&a_dit) != NULL)
+    {
+      for (a_dit.reset(); a_dit.ok(); ++a_dit)
+        {
+          applyOpNoCFBCs(a_opPhi, a_phi, a_dit(), a_homogeneousPhysBC, a_ebFluxBCLD);
+        }
+    }
+  else
+    {
+      int nbox = a_dit.size();
+#pragma omp parallel for schedule(runtime)
+      for (int mybox = 0; mybox < nbox; mybox++)
+        {
+          applyOpNoCFBCs(a_opPhi, a_phi, a_dit[mybox], a_homogeneousPhysBC, a_ebFluxBCLD);
+        }
+    }
+}
+
+void EBAMRPoissonOp::
+applyOpNoCFBCs(LevelData<EBCellFAB>&                    a_opPhi,
+               const LevelData<EBCellFAB>&              a_phi,
+               const DataIndex&                         a_datInd,
+               const bool&                              a_homogeneousPhysBC,
+               const LevelData<BaseIVFAB<Real> >* const a_ebFluxBCLD)
+{
+  CH_TIMERS("EBAMRPoissonOp::applyOpNoCFBCs(box)");
   CH_TIMER("eb_bcs_apply", t3);
   CH_TIMER("regular_apply", t1);
   CH_TIMER("irregular_apply", t2);
   CH_TIMER("dom_bcs_apply", t4);
   CH_TIMER("alpha_apply", t5);
+  unsigned long long startTicks = m_boxCosts.isNull() ? 0 : ch_ticks();
   int nComps = a_phi.nComp();
   LevelData<EBCellFAB>& phi = const_cast<LevelData<EBCellFAB>&>(a_phi);
   bool hasNoEBLevelData = (a_ebFluxBCLD==NULL);
 
-  int ibox = 0;
-  for (a_dit.reset(); a_dit.ok(); ++a_dit)
+  Box dblBox( m_eblg.getDBL().get(a_datInd) );
+  const EBCellFAB& curPhiEBCellFAB = phi[a_datInd];
+  Box curPhiBox = curPhiEBCellFAB.box();
+  const BaseFab<Real>& curPhiFAB = curPhiEBCellFAB.getSingleValuedFAB();
+
+  EBCellFAB& curOpPhiEBCellFAB = a_opPhi[a_datInd];
+  BaseFab<Real>& curOpPhiFAB = curOpPhiEBCellFAB.getSingleValuedFAB();
+
+  CH_START(t5);
+  if (m_alpha == 0)
     {
-      Box dblBox( m_eblg.getDBL().get(a_dit()) );
-      const EBCellFAB& curPhiEBCellFAB = phi[a_dit()];
-      Box curPhiBox = curPhiEBCellFAB.box();
-      const BaseFab<Real>& curPhiFAB = curPhiEBCellFAB.getSingleValuedFAB();
+      curOpPhiEBCellFAB.setVal(0.0);
+    }
+  else
+    {
+      curOpPhiEBCellFAB.copy(curPhiEBCellFAB);
+      curOpPhiEBCellFAB.mult(m_alpha);
+    }
+  CH_STOP(t5);
 
-      EBCellFAB& curOpPhiEBCellFAB = a_opPhi[a_dit()];
-      BaseFab<Real>& curOpPhiFAB = curOpPhiEBCellFAB.getSingleValuedFAB();
 
-      CH_START(t5);
-      if (m_alpha == 0)
+  Box loBox[SpaceDim],hiBox[SpaceDim];
+  int hasLo[SpaceDim],hasHi[SpaceDim];
+  CH_START(t1);
+  applyOpRegularAllDirs( loBox, hiBox, hasLo, hasHi,
+                         dblBox, curPhiBox, nComps,
+                         curOpPhiFAB,
+                         curPhiFAB,
+                         a_homogeneousPhysBC,
+                         a_datInd,
+                         m_beta);
+  CH_STOP(t1);
+
+  CH_START(t2);
+  const BaseIVFAB<Real>& alphaWeight = m_alphaDiagWeight[a_datInd];
+  for (int icomp = 0; icomp < nComps; icomp++)
+    {
+      m_opEBStencil[a_datInd]->apply(curOpPhiEBCellFAB, curPhiEBCellFAB, alphaWeight, m_alpha, m_beta, false, icomp);
+    }
+  CH_STOP(t2);
+
+  CH_START(t4);
+  const BaseIVFAB<Real>& one = m_one[a_datInd];
+  Real alpha;
+  for (int idir = 0; idir < SpaceDim; idir++)
+    {
+      if (a_homogeneousPhysBC)
         {
-          curOpPhiEBCellFAB.setVal(0.0);
+          alpha = 0.;
         }
       else
         {
-          curOpPhiEBCellFAB.copy(curPhiEBCellFAB);
-          curOpPhiEBCellFAB.mult(m_alpha);
+          alpha = -m_beta*m_invDx[idir];
         }
-      CH_STOP(t5);
-
-
-      Box loBox[SpaceDim],hiBox[SpaceDim];
-      int hasLo[SpaceDim],hasHi[SpaceDim];
-      CH_START(t1);
-      applyOpRegularAllDirs( loBox, hiBox, hasLo, hasHi,
-                             dblBox, curPhiBox, nComps,
-                             curOpPhiFAB,
-                             curPhiFAB,
-                             a_homogeneousPhysBC,
-                             a_dit(),
-                             m_beta);
-      CH_STOP(t1);
-
-      CH_START(t2);
-      const BaseIVFAB<Real>& alphaWeight = m_alphaDiagWeight[a_dit()];
-      m_opEBStencil[a_dit()]->apply(curOpPhiEBCellFAB, curPhiEBCellFAB, alphaWeight, m_alpha, m_beta, false);
-      CH_STOP(t2);
-
-      CH_START(t4);
-      const BaseIVFAB<Real>& one = m_one[a_dit];
-      Real alpha;
-      for (int idir = 0; idir < SpaceDim; idir++)
+      for (int icomp = 0; icomp < m_ncomp; icomp++)
         {
-          if (a_homogeneousPhysBC)
-            {
-              alpha = 0.;
-            }
-          else
-            {
-              alpha = -m_beta*m_invDx[idir];
-            }
-          m_opEBStencilInhomDomLo[idir][a_dit]->apply(curOpPhiEBCellFAB,
-                                                      (*m_cacheInhomDomBCLo[s_whichComp][idir])[a_dit()],
-                                                      one,
-                                                      alpha,
-                                                      1.,
-                                                      true);
-
-          if (a_homogeneousPhysBC)
-            {
-              alpha = 0.;
-            }
-          else
-            {
-              alpha = m_beta*m_invDx[idir];
-            }
-          m_opEBStencilInhomDomHi[idir][a_dit]->apply(curOpPhiEBCellFAB,
-                                                      (*m_cacheInhomDomBCHi[s_whichComp][idir])[a_dit()],
-                                                      one,
-                                                      alpha,
-                                                      1.,
-                                                      true);
+          m_opEBStencilInhomDomLo[idir][a_datInd]->apply(curOpPhiEBCellFAB,
+                                                         (*m_cacheInhomDomBCLo[s_whichComp][idir])[a_datInd],
+                                                         one,
+                                                         alpha,
+                                                         1.,
+                                                         true,
+                                                         icomp);
         }
-      CH_STOP(t4);
 
-      const Real factor = m_beta/m_dx[0];
-      CH_START(t3);
-      if (hasNoEBLevelData)
+      if (a_homogeneousPhysBC)
         {
-          //standard EB boundary conditions for inhomogeneous, single fluid
-          if (!a_homogeneousPhysBC)
-            {
-              m_ebBC->applyEBFlux(curOpPhiEBCellFAB, curPhiEBCellFAB, m_vofItIrreg[a_dit()], (*m_eblg.getCFIVS()),
-                                  a_dit(), m_origin, m_dx, factor,
-                                  a_homogeneousPhysBC, s_time);
-            }
+          alpha = 0.;
         }
       else
         {
-          //this stuff is for multifluid
-          const EBISBox& ebisBox = m_eblg.getEBISL()[a_dit()];
-          // Use vofit defined over EBISBox's boundary IVS because this mirrors
-          // a_ebFluxBCLD's VoFs
-          VoFIterator vofit(ebisBox.boundaryIVS(dblBox),ebisBox.getEBGraph());
-          for (vofit.reset(); vofit.ok(); ++vofit)
+          alpha = m_beta*m_invDx[idir];
+        }
+      for (int icomp = 0; icomp < m_ncomp; icomp++)
+        {
+          m_opEBStencilInhomDomHi[idir][a_datInd]->apply(curOpPhiEBCellFAB,
+                                                         (*m_cacheInhomDomBCHi[s_whichComp][idir])[a_datInd],
+                                                         one,
+                                                         alpha,
+                                                         1.,
+                                                         true,
+                                                         icomp);
+        }
+    }
+  CH_STOP(t4);
+
+  const Real factor = m_beta/m_dx[0];
+  CH_START(t3);
+  if (hasNoEBLevelData)
+    {
+      //standard EB boundary conditions for inhomogeneous, single fluid
+      if (!a_homogeneousPhysBC)
+        {
+          m_ebBC->applyEBFlux(curOpPhiEBCellFAB, curPhiEBCellFAB, m_vofItIrreg[a_datInd], (*m_eblg.getCFIVS()),
+                              a_datInd, m_origin, m_dx, factor,
+                              a_homogeneousPhysBC, s_time);
+        }
+    }
+  else
+    {
+      //this stuff is for multifluid
+      const EBISBox& ebisBox = m_eblg.getEBISL()[a_datInd];
+      // Use vofit defined over EBISBox's boundary IVS because this mirrors
+      // a_ebFluxBCLD's VoFs
+      VoFIterator vofit(ebisBox.boundaryIVS(dblBox),ebisBox.getEBGraph());
+      for (vofit.reset(); vofit.ok(); ++vofit)
+        {
+          const VolIndex& vof = vofit();
+          const BaseIVFAB<Real>& ebInputFluxFAB = (*a_ebFluxBCLD)[a_datInd];
+          Real areaFrac = ebisBox.bndryArea(vof);
+          for (int icomp = 0; icomp < nComps; icomp++)
             {
-              const VolIndex& vof = vofit();
-              const BaseIVFAB<Real>& ebInputFluxFAB = (*a_ebFluxBCLD)[a_dit()];
-              Real areaFrac = ebisBox.bndryArea(vof);
-              Real ebFlux = -ebInputFluxFAB(vof, 0);
+              Real ebFlux = -ebInputFluxFAB(vof, icomp);
               ebFlux *= areaFrac;
               // do area fraction scaling. (For single fluid, it was
               // incorporated into the Dirichlet EBBC stencil.)
@@ -1492,13 +1618,16 @@ applyOpNoCFBCs(LevelData<EBCellFAB>&                    a_opPhi,
                 {
                   ebFlux *= ebisBox.areaFracScaling(vof);
                 }
-              curOpPhiEBCellFAB(vof,0) += ebFlux * factor;
+              curOpPhiEBCellFAB(vof,icomp) += ebFlux * factor;
             }
-
         }
-      CH_STOP(t3);
 
-      ibox++;
+    }
+  CH_STOP(t3);
+
+  if (!m_boxCosts.isNull())
+    {
+      m_boxCosts->addCost(a_datInd, ch_ticks() - startTicks);
     }
 }
 
@@ -1696,7 +1825,11 @@ dotProduct(const LevelData<EBCellFAB>& a_1,
   ProblemDomain domain;
   Real volume;
 
+#ifdef CH_MPI
+  return EBLevelDataOps::kappaDotProduct(volume,a_1,a_2,EBLEVELDATAOPS_ALLVOFS,domain,m_comm);
+#else
   return EBLevelDataOps::kappaDotProduct(volume,a_1,a_2,EBLEVELDATAOPS_ALLVOFS,domain);
+#endif
 
   ///warning this will not include kappa and it will include values in covered cells
   //Real sum = 0;
@@ -1752,7 +1885,7 @@ norm(const LevelData<EBCellFAB>& a_rhs,
 #ifdef CH_MPI
   Real tmp = 1.;
   int result = MPI_Allreduce(&maxNorm, &tmp, 1, MPI_CH_REAL,
-                             MPI_MAX, Chombo_MPI::comm);
+                             MPI_MAX, m_comm);
   if (result != MPI_SUCCESS)
     { //bark!!!
       MayDay::Error("sorry, but I had a communcation error on norm");
@@ -1792,15 +1925,19 @@ staticMaxNorm(const LevelData<EBCellFAB>& a_rhs, const EBLevelGrid& a_eblg)
               const Box& box = a_eblg.getDBL().get(dit());
               //             const EBISBox& ebisBox = a_eblg.getEBISL()[dit()];
               const BaseFab<Real>& rhsFAB = (a_rhs[dit()]).getSingleValuedFAB();
-              FORT_MAXNORMMASK(CHF_REAL(maxNorm),
-                               CHF_CONST_FRA1(rhsFAB,0),
-                               CHF_BOX(box),
-                               CHF_CONST_FRA1(maskFAB,0));
+              for (int icomp = 0; icomp < rhsFAB.nComp(); icomp++)
+                {
+                  FORT_MAXNORMMASK(CHF_REAL(maxNorm),
+                                   CHF_CONST_FRA1(rhsFAB,icomp),
+                                   CHF_BOX(box),
+                                   CHF_CONST_FRA1(maskFAB,0));
+                }
 
               //CP: this portion between the stars is the new faster code:
               //****************************
+              //components are stored contiguously so one sweep covers them all
               int srccomp = 0;
-              int ncomp   = 1;
+              int ncomp   = rhsFAB.nComp();
               const BaseIVFAB<Real>& irrBFAB1 = a_rhs[dit()].getMultiValuedFAB();
               const Real* r = irrBFAB1.dataPtr(srccomp);
               int nvof    = irrBFAB1.numVoFs();
@@ -1821,9 +1958,12 @@ staticMaxNorm(const LevelData<EBCellFAB>& a_rhs, const EBLevelGrid& a_eblg)
             {
               const Box& box = a_eblg.getDBL().get(dit());
               const BaseFab<Real>& rhsFAB = (a_rhs[dit()]).getSingleValuedFAB();
-              FORT_MAXNORM(CHF_REAL(maxNorm),
-                           CHF_CONST_FRA1(rhsFAB,0),
-                           CHF_BOX(box));
+              for (int icomp = 0; icomp < rhsFAB.nComp(); icomp++)
+                {
+                  FORT_MAXNORM(CHF_REAL(maxNorm),
+                               CHF_CONST_FRA1(rhsFAB,icomp),
+                               CHF_BOX(box));
+                }
             }
         }
     }
@@ -1856,7 +1996,7 @@ createCoarser(LevelData<EBCellFAB>&       a_coar,
               const LevelData<EBCellFAB>& a_fine,
               bool                        a_ghosted)
 {
-  CH_assert(a_fine.nComp() == 1);
+  CH_assert(a_fine.nComp() == m_ncomp);
   const DisjointBoxLayout& dbl = m_eblgCoarMG.getDBL();
   EBISLayout coarEBISL = m_eblgCoarMG.getEBISL();
   /*
@@ -1870,7 +2010,7 @@ createCoarser(LevelData<EBCellFAB>&       a_coar,
     dbl, coarDom, nghost);
   */
   EBCellFactory ebcellfact(coarEBISL);
-  a_coar.define(dbl, 1,a_fine.ghostVect(),ebcellfact);
+  a_coar.define(dbl, m_ncomp,a_fine.ghostVect(),ebcellfact);
 }
 
 void EBAMRPoissonOp::
@@ -1882,9 +2022,8 @@ relax(LevelData<EBCellFAB>&       a_e,
 
   CH_assert(a_e.ghostVect() == m_ghostCellsPhi);
   CH_assert(a_residual.ghostVect() == m_ghostCellsRHS);
-  CH_assert(a_e.nComp() == 1);
-  CH_assert(a_residual.nComp() == 1);
-
+  CH_assert(a_e.nComp() == m_ncomp);
+  CH_assert(a_residual.nComp() == m_ncomp);
   if (m_relaxType == 1)
     {
       for (int i = 0; i < a_iterations; i++)
@@ -1932,9 +2071,9 @@ restrictResidual(LevelData<EBCellFAB>&       a_resCoar,
 {
   CH_TIME("EBAMRPoissonOp::restrictResidual");
 
-  CH_assert(a_resCoar.nComp() == 1);
-  CH_assert(a_phiThisLevel.nComp() == 1);
-  CH_assert(a_rhsThisLevel.nComp() == 1);
+  CH_assert(a_resCoar.nComp() == m_ncomp);
+  CH_assert(a_phiThisLevel.nComp() == m_ncomp);
+  CH_assert(a_rhsThisLevel.nComp() == m_ncomp);
 
   LevelData<EBCellFAB>& resThisLevel = m_resThisLevel;
   bool homogeneous = true;
@@ -1943,7 +2082,7 @@ restrictResidual(LevelData<EBCellFAB>&       a_resCoar,
   residual(resThisLevel,a_phiThisLevel,a_rhsThisLevel,homogeneous);
 
   // now use our nifty averaging operator
-  Interval variables(0, 0);
+  Interval variables(0, m_ncomp-1);
   m_ebAverageMG.average(a_resCoar, resThisLevel, variables);
 
 #ifdef DO_EB_RHS_CORRECTION
@@ -1994,7 +2133,7 @@ prolongIncrement(LevelData<EBCellFAB>&       a_phiThisLevel,
                  const LevelData<EBCellFAB>& a_correctCoar)
 {
   CH_TIME("EBAMRPoissonOp::prolongIncrement");
-  Interval vars(0, 0);
+  Interval vars(0, m_ncomp-1);
   m_ebInterpMG.pwcInterp(a_phiThisLevel, a_correctCoar, vars);
 }
 //////////
@@ -2009,7 +2148,7 @@ applyCFBCs(LevelData<EBCellFAB>&             a_phi,
   CH_TIMER("inhomogeneous_cfbcs_define",t1);
   CH_TIMER("inhomogeneous_cfbcs_execute",t3);
   CH_TIMER("homogeneous_cfbs",t2);
-  CH_assert(a_phi.nComp() == 1);
+  CH_assert(a_phi.nComp() == m_ncomp);
   if (m_hasCoar)
     {
       if (!a_homogeneousCFBC)
@@ -2021,11 +2160,11 @@ applyCFBCs(LevelData<EBCellFAB>&             a_phi,
             }
           //define coarse fine interpolation object on the fly
           //because most operators do not need it
-          CH_assert(a_phiCoar->nComp() == 1);
+          CH_assert(a_phiCoar->nComp() == m_ncomp);
           CH_STOP(t1);
 
           CH_START(t3);
-          Interval interv(0,0);
+          Interval interv(0,m_ncomp-1);
           m_quadCFIWithCoar->interpolate(a_phi, *a_phiCoar, interv, a_doOnlyRegularInterp);
           CH_STOP(t3);
 
@@ -2044,7 +2183,7 @@ EBAMRPoissonOp::
 applyHomogeneousCFBCs(LevelData<EBCellFAB>&   a_phi)
 {
   CH_TIME("EBAMRPoissonOp::applyHomogeneousCFBCs");
-  CH_assert(a_phi.nComp() == 1);
+  CH_assert(a_phi.nComp() == m_ncomp);
   CH_assert( a_phi.ghostVect() >= IntVect::Unit);
   for (DataIterator dit = m_eblg.getDBL().dataIterator(); dit.ok(); ++dit)
     {
@@ -2070,8 +2209,7 @@ applyHomogeneousCFBCs(EBCellFAB&            a_phi,
   CH_TIMER("unpacked_applyHomogeneousCFBCs",t2);
   CH_assert((a_idir >= 0) && (a_idir  < SpaceDim));
   CH_assert((a_hiorlo == Side::Lo )||(a_hiorlo == Side::Hi ));
-  CH_assert(a_phi.nComp() == 1);
-  int ivar = 0;
+  CH_assert(a_phi.nComp() == m_ncomp);
 
   const CFIVS* cfivsPtr = NULL;
 
@@ -2117,10 +2255,6 @@ applyHomogeneousCFBCs(EBCellFAB&            a_phi,
             {
               const VolIndex& VoFGhost = vofit();
 
-              IntVect ivGhost  = VoFGhost.gridIndex();
-              IntVect ivClose =  ivGhost;
-              IntVect ivFar   =  ivGhost;
-
               Vector<VolIndex> farVoFs;
               Vector<VolIndex> closeVoFs = ebisBox.getVoFs(VoFGhost,
                                                            a_idir,
@@ -2128,55 +2262,62 @@ applyHomogeneousCFBCs(EBCellFAB&            a_phi,
                                                            1);
               bool hasClose = (closeVoFs.size() > 0);
               bool hasFar = false;
-              Real phic = 0.0;
-              Real phif = 0.0;
               if (hasClose)
                 {
-                  const int& numClose = closeVoFs.size();
-                  for (int iVof=0;iVof<numClose;iVof++)
-                    {
-                      const VolIndex& vofClose = closeVoFs[iVof];
-                      phic += a_phi(vofClose,0);
-                    }
-                  phic /= Real(numClose);
-
                   farVoFs = ebisBox.getVoFs(VoFGhost,
                                             a_idir,
                                             flip(a_hiorlo),
                                             2);
                   hasFar   = (farVoFs.size()   > 0);
-                  if (hasFar)
+                }
+
+              for (int ivar = 0; ivar < m_ncomp; ivar++)
+                {
+                  Real phic = 0.0;
+                  Real phif = 0.0;
+                  if (hasClose)
                     {
-                      const int& numFar = farVoFs.size();
-                      for (int iVof=0;iVof<numFar;iVof++)
+                      const int& numClose = closeVoFs.size();
+                      for (int iVof=0;iVof<numClose;iVof++)
                         {
-                          const VolIndex& vofFar = farVoFs[iVof];
-                          phif += a_phi(vofFar,0);
+                          const VolIndex& vofClose = closeVoFs[iVof];
+                          phic += a_phi(vofClose,ivar);
+                        }
+                      phic /= Real(numClose);
+
+                      if (hasFar)
+                        {
+                          const int& numFar = farVoFs.size();
+                          for (int iVof=0;iVof<numFar;iVof++)
+                            {
+                              const VolIndex& vofFar = farVoFs[iVof];
+                              phif += a_phi(vofFar,ivar);
+                            }
+                          phif /= Real(numFar);
                         }
-                      phif /= Real(numFar);
                     }
-                }
 
-              Real phiGhost;
-              if (hasClose && hasFar)
-                {
-                  // quadratic interpolation  phi = ax^2 + bx + c
-                  Real A = (phif*xc - phic*xf)/denom;
-                  Real B = (phic*hf*xf - phif*xc*xc + phic*xf*xc)/denom;
+                  Real phiGhost;
+                  if (hasClose && hasFar)
+                    {
+                      // quadratic interpolation  phi = ax^2 + bx + c
+                      Real A = (phif*xc - phic*xf)/denom;
+                      Real B = (phic*hf*xf - phif*xc*xc + phic*xf*xc)/denom;
 
-                  phiGhost = A*xg*xg + B*xg;
-                }
-              else if (hasClose)
-                {
-                  //linear interpolation
-                  Real slope =  phic/xc;
-                  phiGhost   =  slope*xg;
-                }
-              else
-                {
-                  phiGhost = 0.0; //nothing to interpolate from
+                      phiGhost = A*xg*xg + B*xg;
+                    }
+                  else if (hasClose)
+                    {
+                      //linear interpolation
+                      Real slope =  phic/xc;
+                      phiGhost   =  slope*xg;
+                    }
+                  else
+                    {
+                      phiGhost = 0.0; //nothing to interpolate from
+                    }
+                  a_phi(VoFGhost, ivar) = phiGhost;
                 }
-              a_phi(VoFGhost, ivar) = phiGhost;
             }
           CH_STOP(t2);
         }
@@ -2211,9 +2352,9 @@ AMRResidual(LevelData<EBCellFAB>&       a_residual,
   CH_TIMER("axby", t2);
   CH_assert(a_residual.ghostVect() == m_ghostCellsRHS);
   CH_assert(a_rhs.ghostVect() == m_ghostCellsRHS);
-  CH_assert(a_residual.nComp() == 1);
-  CH_assert(a_phi.nComp() == 1);
-  CH_assert(a_rhs.nComp() == 1);
+  CH_assert(a_residual.nComp() == m_ncomp);
+  CH_assert(a_phi.nComp() == m_ncomp);
+  CH_assert(a_rhs.nComp() == m_ncomp);
 
   CH_START(t1);
   AMROperator(a_residual, a_phiFine, a_phi, a_phiCoar,
@@ -2241,8 +2382,22 @@ AMROperator(LevelData<EBCellFAB>&       a_LofPhi,
   CH_TIMER("applyOp", t1);
   CH_TIMER("reflux", t2);
   CH_assert(a_LofPhi.ghostVect() == m_ghostCellsRHS);
-  CH_assert(a_LofPhi.nComp() == 1);
-  CH_assert(a_phi.nComp() == 1);
+  CH_assert(a_LofPhi.nComp() == m_ncomp);
+  CH_assert(a_phi.nComp() == m_ncomp);
+
+  //the fine fluxes do not depend on L(phi), so send the fine registers
+  //off before applying the operator and finish refluxing afterward
+  Interval interv(0,m_ncomp-1);
+  Real scale = 1.0/m_dx[0];
+  if (m_hasFine)
+    {
+      CH_assert(a_finerOp != NULL);
+      CH_START(t2);
+      m_fastFR.setToZero();
+      fast_incrementFRFine(a_phiFine, a_phi, a_finerOp);
+      m_fastFR.refluxBegin(a_LofPhi, interv, scale);
+      CH_STOP(t2);
+    }
 
   //apply the operator between this and the next coarser level.
   CH_START(t1);
@@ -2252,9 +2407,9 @@ AMROperator(LevelData<EBCellFAB>&       a_LofPhi,
   //now reflux to enforce flux-matching from finer levels
   if (m_hasFine)
     {
-      CH_assert(a_finerOp != NULL);
       CH_START(t2);
-      reflux(a_LofPhi, a_phiFine, a_phi, a_finerOp);
+      fast_incrementFRCoar(a_phiFine, a_phi);
+      m_fastFR.refluxEnd(a_LofPhi, interv, scale);
       CH_STOP(t2);
     }
 }
@@ -2284,9 +2439,9 @@ fast_reflux(LevelData<EBCellFAB>& a_residual,
   CH_TIMER("incrementCoar",t3);
   CH_TIMER("incrementFine",t4);
   CH_TIMER("reflux_from_reg",t5);
-  Interval interv(0,0);
+  Interval interv(0,m_ncomp-1);
   CH_START(t1);
-  CH_assert(a_phiFine.nComp() == 1);
+  CH_assert(a_phiFine.nComp() == m_ncomp);
 
   CH_STOP(t1);
   CH_START(t2);
@@ -2312,11 +2467,11 @@ fast_incrementFRCoar(const LevelData<EBCellFAB>& a_phiFine,
                      const LevelData<EBCellFAB>& a_phi)
 {
   CH_TIME("EBAMRPoissonOp::incrementFRCoar");
-  CH_assert(a_phiFine.nComp() == 1);
-  CH_assert(a_phi.nComp() == 1);
+  CH_assert(a_phiFine.nComp() == m_ncomp);
+  CH_assert(a_phi.nComp() == m_ncomp);
 
-  int ncomp = 1;
-  Interval interv(0,0);
+  int ncomp = m_ncomp;
+  Interval interv(0,m_ncomp-1);
 
   for (DataIterator dit = m_eblg.getDBL().dataIterator(); dit.ok(); ++dit)
     {
@@ -2366,11 +2521,11 @@ fast_incrementFRFine(const LevelData<EBCellFAB>& a_phiFine,
                      AMRLevelOp<LevelData<EBCellFAB> >* a_finerOp)
 {
   CH_TIME("EBAMRPoissonOp::incrementFRFine");
-  CH_assert(a_phiFine.nComp() == 1);
-  CH_assert(a_phi.nComp() == 1);
+  CH_assert(a_phiFine.nComp() == m_ncomp);
+  CH_assert(a_phi.nComp() == m_ncomp);
   CH_assert(m_hasFine);
-  int ncomp = 1;
-  Interval interv(0,0);
+  int ncomp = m_ncomp;
+  Interval interv(0,m_ncomp-1);
   EBAMRPoissonOp& finerEBAMROp = (EBAMRPoissonOp& )(*a_finerOp);
 
   //ghost cells of phiFine need to be filled
@@ -2452,7 +2607,7 @@ getFlux(EBFaceFAB&                    a_fluxCentroid,
 
   {
     CH_TIME("irregular stuff");
-    EBFaceFAB fluxCenter(a_ebisBox, a_ghostedBox, a_idir,1);
+    EBFaceFAB fluxCenter(a_ebisBox, a_ghostedBox, a_idir,ncomp);
     fluxCenter.copy(a_fluxCentroid);
 
     IntVectSet ivsCell = a_ebisBox.getIrregIVS(cellBox);
@@ -2471,11 +2626,14 @@ getFlux(EBFaceFAB&                    a_fluxCentroid,
              faceit.ok(); ++faceit)
           {
             const FaceIndex& face = faceit();
-            Real phiHi = a_phi(face.getVoF(Side::Hi), 0);
-            Real phiLo = a_phi(face.getVoF(Side::Lo), 0);
-            Real fluxFace = m_beta*(phiHi - phiLo)/a_dx[a_idir];
-
-            fluxCenter(face, 0) = fluxFace;
+            for (int icomp = 0; icomp < ncomp; icomp++)
+              {
+                Real phiHi = a_phi(face.getVoF(Side::Hi), icomp);
+                Real phiLo = a_phi(face.getVoF(Side::Lo), icomp);
+                Real fluxFace = m_beta*(phiHi - phiLo)/a_dx[a_idir];
+
+                fluxCenter(face, icomp) = fluxFace;
+              }
           }
         //interpolate from face centers to face centroids
         Box cellBox = a_fluxCentroid.getCellRegion();
@@ -2510,13 +2668,16 @@ getFluxEBCF(EBFaceFAB&                    a_flux,
         {
           const FaceIndex& face =     a_faceitEBCF[iface];
           const VoFStencil& stencil   = a_stenEBCF[iface];
-          Real fluxval = 0;
-          for (int isten = 0; isten < stencil.size(); isten++)
+          for (int icomp = 0; icomp < a_phi.nComp(); icomp++)
             {
-              fluxval += stencil.weight(isten)*(a_phi(stencil.vof(isten), 0));
+              Real fluxval = 0;
+              for (int isten = 0; isten < stencil.size(); isten++)
+                {
+                  fluxval += stencil.weight(isten)*(a_phi(stencil.vof(isten), icomp));
+                }
+              //note the last minute beta
+              a_flux(face, icomp) = m_beta*fluxval;
             }
-          //note the last minute beta
-          a_flux(face, 0) = m_beta*fluxval;
         }
     }
 }
@@ -2948,9 +3109,9 @@ AMRRestrict(LevelData<EBCellFAB>&       a_resCoar,
   CH_assert(a_coarCorrection.ghostVect() == m_ghostCellsPhi);
   CH_assert(!a_skip_res);
 
-  CH_assert(a_residual.nComp() == 1);
-  CH_assert(a_resCoar.nComp() == 1);
-  CH_assert(a_correction.nComp() == 1);
+  CH_assert(a_residual.nComp() == m_ncomp);
+  CH_assert(a_resCoar.nComp() == m_ncomp);
+  CH_assert(a_correction.nComp() == m_ncomp);
 
   LevelData<EBCellFAB>& resThisLevel = m_resThisLevel;
   bool homogeneousPhys = true;
@@ -2964,7 +3125,7 @@ AMRRestrict(LevelData<EBCellFAB>&       a_resCoar,
   scale(resThisLevel,-1.0);
 
   //use our nifty averaging operator
-  Interval variables(0, 0);
+  Interval variables(0, m_ncomp-1);
   CH_assert(m_hasInterpAve);
   m_ebAverage.average(a_resCoar, resThisLevel, variables);
 }
@@ -3029,7 +3190,7 @@ AMRProlong(LevelData<EBCellFAB>&       a_correction,
 {
   CH_TIME("EBAMRPoissonOp::AMRProlong");
   //use cached interpolation object
-  Interval variables(0, 0);
+  Interval variables(0, m_ncomp-1);
   CH_assert(m_hasInterpAve);
   m_ebInterp.pwcInterp(a_correction, a_coarCorrection, variables);
 }
@@ -3051,7 +3212,7 @@ AMRUpdateResidual(LevelData<EBCellFAB>&       a_residual,
   EBCellFactory ebcellfactTL(m_eblg.getEBISL());
   IntVect ghostVec = a_residual.ghostVect();
 
-  lcorr.define(m_eblg.getDBL(), 1, ghostVec, ebcellfactTL);
+  lcorr.define(m_eblg.getDBL(), m_ncomp, ghostVec, ebcellfactTL);
 
   applyOp(lcorr, a_correction, &a_coarCorrection, homogeneousPhys, homogeneousCF);
 
@@ -3077,7 +3238,7 @@ AMRUpdateResidual(LevelData<EBCellFAB>&       a_residual,
   EBCellFactory ebcellfactTL(m_eblg.getEBISL());
   IntVect ghostVec = a_residual.ghostVect();
 
-  lcorr.define(m_eblg.getDBL(), 1, ghostVec, ebcellfactTL);
+  lcorr.define(m_eblg.getDBL(), m_ncomp, ghostVec, ebcellfactTL);
 
   applyOp(lcorr, a_correction, &a_coarCorrection, homogeneousPhys, homogeneousCF, a_ebFluxBCLD);
 
@@ -3095,17 +3256,20 @@ levelMultiColorGS(LevelData<EBCellFAB>&       a_phi,
   CH_assert(a_phi.ghostVect()    == m_ghostCellsPhi);
 
   int nComps = a_phi.nComp();
-  for (DataIterator dit = a_phi.dataIterator(); dit.ok(); ++dit)
+  DataIterator dit = a_phi.dataIterator();
+  int nbox = dit.size();
+#pragma omp parallel for schedule(runtime)
+  for (int mybox = 0; mybox < nbox; mybox++)
     {
-      Box dblBox(m_eblg.getDBL().get(dit()));
-      BaseFab<Real>& phiFAB       = (a_phi[dit()] ).getSingleValuedFAB();
+      Box dblBox(m_eblg.getDBL().get(dit[mybox]));
+      BaseFab<Real>& phiFAB       = (a_phi[dit[mybox]] ).getSingleValuedFAB();
 
       Box loBox[SpaceDim],hiBox[SpaceDim];
       int hasLo[SpaceDim],hasHi[SpaceDim];
 
       applyDomainFlux(loBox, hiBox, hasLo, hasHi,
                       dblBox, nComps, phiFAB,
-                      true, dit(), m_beta);
+                      true, dit[mybox], m_beta);
 
     }
 
@@ -3143,20 +3307,37 @@ colorGS(LevelData<EBCellFAB>&       a_phi,
     }
   weight = 1.0 / weight;
 
-  for (DataIterator dit = a_phi.dataIterator(); dit.ok(); ++dit)
+  DataIterator dit = a_phi.dataIterator();
+  int nbox = dit.size();
+#pragma omp parallel for schedule(runtime)
+  for (int mybox = 0; mybox < nbox; mybox++)
     {
-      EBCellFAB& phifab = a_phi[dit()];
-      const EBCellFAB& rhsfab = a_rhs[dit()];
-      BaseFab<Real>& phiBaseFAB = (a_phi[dit()]).getSingleValuedFAB();
-      const BaseFab<Real>& rhsBaseFAB = (a_rhs[dit()] ).getSingleValuedFAB();
+      unsigned long long startTicks = m_boxCosts.isNull() ? 0 : ch_ticks();
+      EBCellFAB& phifab = a_phi[dit[mybox]];
+      const EBCellFAB& rhsfab = a_rhs[dit[mybox]];
+      BaseFab<Real>& phiBaseFAB = (a_phi[dit[mybox]]).getSingleValuedFAB();
+      const BaseFab<Real>& rhsBaseFAB = (a_rhs[dit[mybox]] ).getSingleValuedFAB();
+
+      //the stencil caches one component at a time so the regular
+      //sweep has to be done one component at a time as well
+      for (int icomp = 0; icomp < phiBaseFAB.nComp(); icomp++)
+        {
+          BaseFab<Real> phiCompFAB(Interval(icomp, icomp), phiBaseFAB);
+          BaseFab<Real>& rhsAlias = (BaseFab<Real>&) rhsBaseFAB;
+          const BaseFab<Real> rhsCompFAB(Interval(icomp, icomp), rhsAlias);
 
-      m_colorEBStencil[a_icolor][dit()]->cachePhi(phifab);
+          m_colorEBStencil[a_icolor][dit[mybox]]->cachePhi(phifab, icomp);
 
-      GSColorAllRegular(phiBaseFAB, rhsBaseFAB, a_icolor, weight, homogeneous, dit());
+          GSColorAllRegular(phiCompFAB, rhsCompFAB, a_icolor, weight, homogeneous, dit[mybox]);
 
-      m_colorEBStencil[a_icolor][dit()]->uncachePhi(phifab);
+          m_colorEBStencil[a_icolor][dit[mybox]]->uncachePhi(phifab, icomp);
 
-      GSColorAllIrregular(phifab, rhsfab, a_icolor, homogeneous, dit());
+          GSColorAllIrregular(phifab, rhsfab, a_icolor, homogeneous, dit[mybox], icomp);
+        }
+      if (!m_boxCosts.isNull())
+        {
+          m_boxCosts->addCost(dit[mybox], ch_ticks() - startTicks);
+        }
     }
 }
 
@@ -3204,7 +3385,8 @@ GSColorAllIrregular(EBCellFAB&                   a_phi,
                     const EBCellFAB&             a_rhs,
                     const int&                   a_icolor,
                     const bool&                  a_homogeneousPhysBC,
-                    const DataIndex&             a_dit)
+                    const DataIndex&             a_dit,
+                    int                          a_comp)
 {
   CH_TIMERS("EBAMRPoissonOp::GSColorAllIrregular");
   CH_TIMER("assignAlphaBetaWeights", t1);
@@ -3220,7 +3402,7 @@ GSColorAllIrregular(EBCellFAB&                   a_phi,
       CH_START(t2);
       //phi = (I-lambda*L)phiOld
       Real safety = 1.0;
-      m_colorEBStencil[a_icolor][a_dit]->relax(a_phi, a_rhs, curAlphaWeight, curBetaWeight, m_alpha, m_beta, safety);
+      m_colorEBStencil[a_icolor][a_dit]->relax(a_phi, a_rhs, curAlphaWeight, curBetaWeight, m_alpha, m_beta, safety, a_comp);
       CH_STOP(t2);
 
     } //vofitIrregColor.size() != 0
@@ -3242,11 +3424,13 @@ levelGSRB(LevelData<EBCellFAB>&       a_phi,
   const DisjointBoxLayout& dbl = a_phi.disjointBoxLayout();
 
   int nComps = a_phi.nComp();
-  int ibox = 0;
-  for (DataIterator dit = a_phi.dataIterator(); dit.ok(); ++dit)
+  DataIterator dit = a_phi.dataIterator();
+  int nbox = dit.size();
+#pragma omp parallel for schedule(runtime)
+  for (int mybox = 0; mybox < nbox; mybox++)
     {
-      Box dblBox(m_eblg.getDBL().get(dit()));
-      BaseFab<Real>& phiFAB       = (a_phi[dit()] ).getSingleValuedFAB();
+      Box dblBox(m_eblg.getDBL().get(dit[mybox]));
+      BaseFab<Real>& phiFAB       = (a_phi[dit[mybox]] ).getSingleValuedFAB();
 
       Box loBox[SpaceDim],hiBox[SpaceDim];
       int hasLo[SpaceDim],hasHi[SpaceDim];
@@ -3256,7 +3440,7 @@ levelGSRB(LevelData<EBCellFAB>&       a_phi,
 
         applyDomainFlux(loBox, hiBox, hasLo, hasHi,
                         dblBox, nComps, phiFAB,
-                        homogeneous, dit(),m_beta);
+                        homogeneous, dit[mybox],m_beta);
       }
     }
 
@@ -3286,25 +3470,27 @@ levelGSRB(LevelData<EBCellFAB>&       a_phi,
         }
       weight = 1.0 / weight;
 
-      for (DataIterator dit = a_phi.dataIterator(); dit.ok(); ++dit)
+#pragma omp parallel for schedule(runtime)
+      for (int mybox = 0; mybox < nbox; mybox++)
         {
-          EBCellFAB& phifab = a_phi[dit()];
-          const EBCellFAB& rhsfab = a_rhs[dit()];
-
-          //cache phi
-          for (int c = 0; c < m_colors.size()/2; ++c)
-            {
-              m_colorEBStencil[m_colors.size()/2*redBlack+c][dit()]->cachePhi(phifab);
-            }
+          unsigned long long startTicks = m_boxCosts.isNull() ? 0 : ch_ticks();
+          EBCellFAB& phifab = a_phi[dit[mybox]];
+          const EBCellFAB& rhsfab = a_rhs[dit[mybox]];
 
-          //reg cells
-          const Box& region = dbl.get(dit());
-          Box dblBox(m_eblg.getDBL().get(dit()));
-          BaseFab<Real>& phiBaseFAB       = (a_phi[dit()] ).getSingleValuedFAB();
-          const BaseFab<Real>& rhsBaseFAB = (a_rhs[dit()] ).getSingleValuedFAB();
+          const Box& region = dbl.get(dit[mybox]);
+          BaseFab<Real>& phiBaseFAB       = (a_phi[dit[mybox]] ).getSingleValuedFAB();
+          const BaseFab<Real>& rhsBaseFAB = (a_rhs[dit[mybox]] ).getSingleValuedFAB();
 
+          //the stencils cache one component at a time
           for (int comp = 0; comp < a_phi.nComp(); comp++)
             {
+              //cache phi
+              for (int c = 0; c < m_colors.size()/2; ++c)
+                {
+                  m_colorEBStencil[m_colors.size()/2*redBlack+c][dit[mybox]]->cachePhi(phifab, comp);
+                }
+
+              //reg cells
               FORT_DOALLREGULARGSRB(CHF_FRA1(phiBaseFAB,comp),
                                     CHF_CONST_FRA1(rhsBaseFAB,comp),
                                     CHF_CONST_REAL(weight),
@@ -3313,19 +3499,22 @@ levelGSRB(LevelData<EBCellFAB>&       a_phi,
                                     CHF_CONST_REALVECT(m_dx),
                                     CHF_BOX(region),
                                     CHF_CONST_INT(redBlack));
-            }
 
-          //uncache phi
-          for (int c = 0; c < m_colors.size()/2; ++c)
-            {
-              m_colorEBStencil[m_colors.size()/2*redBlack+c][dit()]->uncachePhi(phifab);
-            }
+              //uncache phi
+              for (int c = 0; c < m_colors.size()/2; ++c)
+                {
+                  m_colorEBStencil[m_colors.size()/2*redBlack+c][dit[mybox]]->uncachePhi(phifab, comp);
+                }
 
-          for (int c = 0; c < m_colors.size()/2; ++c)
+              for (int c = 0; c < m_colors.size()/2; ++c)
+                {
+                  GSColorAllIrregular(phifab, rhsfab, m_colors.size()/2*redBlack+c, homogeneous, dit[mybox], comp);
+                }
+            }
+          if (!m_boxCosts.isNull())
             {
-              GSColorAllIrregular(phifab, rhsfab, m_colors.size()/2*redBlack+c, homogeneous, dit());
+              m_boxCosts->addCost(dit[mybox], ch_ticks() - startTicks);
             }
-          ibox++;
         }
     }
 }
@@ -3396,21 +3585,24 @@ GSColorAllRegularClone(LevelData<EBCellFAB>&       a_phi,
   CH_TIME("EBAMRPoissonOp::GSColorAllRegular");
 
   int nComps = a_phi.nComp();
-  for (DataIterator dit = a_phi.dataIterator(); dit.ok(); ++dit)
+  DataIterator dit = a_phi.dataIterator();
+  int nbox = dit.size();
+#pragma omp parallel for schedule(runtime)
+  for (int mybox = 0; mybox < nbox; mybox++)
     {
-      Box dblBox(m_eblg.getDBL().get(dit()));
-      BaseFab<Real>& phiFAB       = (a_phi[dit()] ).getSingleValuedFAB();
-      const BaseFab<Real>& rhsFAB = (a_rhs[dit()] ).getSingleValuedFAB();
+      Box dblBox(m_eblg.getDBL().get(dit[mybox]));
+      BaseFab<Real>& phiFAB       = (a_phi[dit[mybox]] ).getSingleValuedFAB();
+      const BaseFab<Real>& rhsFAB = (a_rhs[dit[mybox]] ).getSingleValuedFAB();
 
-      EBCellFAB& phi = a_phi[dit()];
-      m_colorEBStencil[a_icolor][dit()]->cachePhi(phi);
+      EBCellFAB& phi = a_phi[dit[mybox]];
+      m_colorEBStencil[a_icolor][dit[mybox]]->cachePhi(phi);
 
       Box loBox[SpaceDim],hiBox[SpaceDim];
       int hasLo[SpaceDim],hasHi[SpaceDim];
 
       applyDomainFlux(loBox, hiBox, hasLo, hasHi,
                       dblBox, nComps, phiFAB,
-                      a_homogeneousPhysBC, dit(),m_beta);
+                      a_homogeneousPhysBC, dit[mybox],m_beta);
 
       IntVect loIV = dblBox.smallEnd();
       IntVect hiIV = dblBox.bigEnd();
@@ -3453,24 +3645,27 @@ GSColorAllIrregularClone(LevelData<EBCellFAB>&        a_phi,
   CH_TIMER("vofItDomLoBCS", t2);
   CH_TIMER("vofItDomHiBCS", t3);
 
-  for (DataIterator dit = a_phi.dataIterator(); dit.ok(); ++dit)
+  DataIterator dit = a_phi.dataIterator();
+  int nbox = dit.size();
+#pragma omp parallel for schedule(runtime)
+  for (int mybox = 0; mybox < nbox; mybox++)
     {
-      if (m_vofItIrregColor[a_icolor][dit()].size() != 0)
+      if (m_vofItIrregColor[a_icolor][dit[mybox]].size() != 0)
         {
-          Box dblBox( m_eblg.getDBL().get(dit()) );
+          Box dblBox( m_eblg.getDBL().get(dit[mybox]) );
 
-          EBCellFAB&          phi = a_phi[   dit()];
-          const EBCellFAB& phiOld = a_phiOld[dit()];
-          const EBCellFAB& rhs = a_rhs[dit()];
+          EBCellFAB&          phi = a_phi[   dit[mybox]];
+          const EBCellFAB& phiOld = a_phiOld[dit[mybox]];
+          const EBCellFAB& rhs = a_rhs[dit[mybox]];
 
-          const BaseIVFAB<Real>& curAlphaWeight = m_alphaDiagWeight[dit()];
-          const BaseIVFAB<Real>& curBetaWeight  = m_betaDiagWeight[dit()];
+          const BaseIVFAB<Real>& curAlphaWeight = m_alphaDiagWeight[dit[mybox]];
+          const BaseIVFAB<Real>& curBetaWeight  = m_betaDiagWeight[dit[mybox]];
           int comp = 0;
 
           CH_START(t1);
           //phi = (I-lambda*L)phiOld
           Real safety = 1.0;
-          m_colorEBStencil[a_icolor][dit()]->relaxClone(phi, phiOld, rhs, curAlphaWeight, curBetaWeight, m_alpha, m_beta, safety);
+          m_colorEBStencil[a_icolor][dit[mybox]]->relaxClone(phi, phiOld, rhs, curAlphaWeight, curBetaWeight, m_alpha, m_beta, safety);
           CH_STOP(t1);
 
           //apply domain bcs to (I-lambda*L)phi (already done in colorStencil += fluxStencil, and hom only here))
@@ -3478,26 +3673,26 @@ GSColorAllIrregularClone(LevelData<EBCellFAB>&        a_phi,
           for (int idir = 0; idir < SpaceDim; idir++)
             {
               CH_START(t2);
-              for (m_vofItIrregColorDomLo[a_icolor][idir][dit()].reset(); m_vofItIrregColorDomLo[a_icolor][idir][dit()].ok();  ++m_vofItIrregColorDomLo[a_icolor][idir][dit()])
+              for (m_vofItIrregColorDomLo[a_icolor][idir][dit[mybox]].reset(); m_vofItIrregColorDomLo[a_icolor][idir][dit[mybox]].ok();  ++m_vofItIrregColorDomLo[a_icolor][idir][dit[mybox]])
                 {
                   Real flux;
-                  const VolIndex& vof = m_vofItIrregColorDomLo[a_icolor][idir][dit()]();
+                  const VolIndex& vof = m_vofItIrregColorDomLo[a_icolor][idir][dit[mybox]]();
                   Real weightIrreg = m_alpha*curAlphaWeight(vof,0) + m_beta*curBetaWeight(vof,0);
                   m_domainBC->getFaceFlux(flux,vof,comp,phiOld,
-                                          m_origin,m_dx,idir,Side::Lo, dit(), s_time,
+                                          m_origin,m_dx,idir,Side::Lo, dit[mybox], s_time,
                                           a_homogeneousPhysBC);
 
                   phi(vof,comp) += (1./weightIrreg) * flux * m_beta*m_invDx[idir];
                 }
               CH_STOP(t2);
               CH_START(t3);
-              for (m_vofItIrregColorDomHi[a_icolor][idir][dit()].reset(); m_vofItIrregColorDomHi[a_icolor][idir][dit()].ok();  ++m_vofItIrregColorDomHi[a_icolor][idir][dit()])
+              for (m_vofItIrregColorDomHi[a_icolor][idir][dit[mybox]].reset(); m_vofItIrregColorDomHi[a_icolor][idir][dit[mybox]].ok();  ++m_vofItIrregColorDomHi[a_icolor][idir][dit[mybox]])
                 {
                   Real flux;
-                  const VolIndex& vof = m_vofItIrregColorDomHi[a_icolor][idir][dit()]();
+                  const VolIndex& vof = m_vofItIrregColorDomHi[a_icolor][idir][dit[mybox]]();
                   Real weightIrreg = m_alpha*curAlphaWeight(vof,0) + m_beta*curBetaWeight(vof,0);
                   m_domainBC->getFaceFlux(flux,vof,comp,phiOld,
-                                          m_origin,m_dx,idir,Side::Hi,dit(),s_time,
+                                          m_origin,m_dx,idir,Side::Hi,dit[mybox],s_time,
                                           a_homogeneousPhysBC);
 
                   phi(vof,comp) -= (1./weightIrreg) * flux * m_beta*m_invDx[idir];
@@ -3526,14 +3721,16 @@ levelGSRB(LevelData<EBCellFAB>&       a_phi,
     }
   weight = 1.0 / weight;
 
-  int ibox = 0;
-  for (DataIterator dit = a_phi.dataIterator(); dit.ok(); ++dit)
+  DataIterator dit = a_phi.dataIterator();
+  int nbox = dit.size();
+#pragma omp parallel for schedule(runtime)
+  for (int mybox = 0; mybox < nbox; mybox++)
     {
-      EBCellFAB&       phifab = a_phi[dit()];
-      const EBCellFAB& residfab = a_resid[dit()];
+      EBCellFAB&       phifab = a_phi[dit[mybox]];
+      const EBCellFAB& residfab = a_resid[dit[mybox]];
 
       //reg cells
-      const Box&                 region =      dbl.get(dit());
+      const Box&                 region =      dbl.get(dit[mybox]);
       BaseFab<Real>&         phiBaseFAB =   phifab.getSingleValuedFAB();
       const BaseFab<Real>& residBaseFAB = residfab.getSingleValuedFAB();
 
@@ -3547,10 +3744,10 @@ levelGSRB(LevelData<EBCellFAB>&       a_phi,
         }
 
       // Do the irregular cells
-      const BaseIVFAB<Real>& curAlphaWeight = m_alphaDiagWeight[dit()];
-      const BaseIVFAB<Real>& curBetaWeight  = m_betaDiagWeight[dit()];
+      const BaseIVFAB<Real>& curAlphaWeight = m_alphaDiagWeight[dit[mybox]];
+      const BaseIVFAB<Real>& curBetaWeight  = m_betaDiagWeight[dit[mybox]];
 
-      VoFIterator& vofit = m_vofItIrreg[dit()];
+      VoFIterator& vofit = m_vofItIrreg[dit[mybox]];
       for (vofit.reset(); vofit.ok(); ++vofit)
         {
           const VolIndex& VoF = vofit();
@@ -3578,7 +3775,6 @@ levelGSRB(LevelData<EBCellFAB>&       a_phi,
                 }
             }
         }
-      ibox++;
     }
 }
 
@@ -3597,12 +3793,14 @@ levelMultiColorGS(LevelData<EBCellFAB>&       a_phi,
     }
   weight = 1.0 / weight;
 
-  int ibox = 0;
-  for (DataIterator dit = m_eblg.getDBL().dataIterator(); dit.ok(); ++dit)
+  DataIterator dit = m_eblg.getDBL().dataIterator();
+  int nbox = dit.size();
+#pragma omp parallel for schedule(runtime)
+  for (int mybox = 0; mybox < nbox; mybox++)
     {
-      EBCellFAB& phi = a_phi[dit()];
-      const Box& box   = m_eblg.getDBL().get(dit());
-      const EBCellFAB& resid = a_resid[dit()];
+      EBCellFAB& phi = a_phi[dit[mybox]];
+      const Box& box   = m_eblg.getDBL().get(dit[mybox]);
+      const EBCellFAB& resid = a_resid[dit[mybox]];
 
       // Do the regular cells
       BaseFab<Real>& phiFAB         =   phi.getSingleValuedFAB();
@@ -3631,10 +3829,10 @@ levelMultiColorGS(LevelData<EBCellFAB>&       a_phi,
         }
 
       // Do the irregular cells
-      const BaseIVFAB<Real>& curAlphaWeight = m_alphaDiagWeight[dit()];
-      const BaseIVFAB<Real>& curBetaWeight  = m_betaDiagWeight[dit()];
+      const BaseIVFAB<Real>& curAlphaWeight = m_alphaDiagWeight[dit[mybox]];
+      const BaseIVFAB<Real>& curBetaWeight  = m_betaDiagWeight[dit[mybox]];
 
-      VoFIterator& vofit = m_vofItIrreg[dit()];
+      VoFIterator& vofit = m_vofItIrreg[dit[mybox]];
       for (vofit.reset(); vofit.ok(); ++vofit)
         {
           const VolIndex& VoF = vofit();
@@ -3671,7 +3869,6 @@ levelMultiColorGS(LevelData<EBCellFAB>&       a_phi,
                 }
             }
         }
-      ibox++;
     }
 }
 
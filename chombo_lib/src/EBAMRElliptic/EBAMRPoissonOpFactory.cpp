@@ -69,6 +69,7 @@ EBAMRPoissonOpFactory(const Vector<EBLevelGrid>&                    a_eblgVec,
 {
   CH_assert(a_eblgVec.size() <= a_refRatio.size());
   m_dataBased = false;
+  m_ncomp = 1;
   if (a_numLevels > 0)
     {
       m_numLevels = a_numLevels;
@@ -357,8 +358,13 @@ EBAMRPoissonOpFactory::createOperator(const EBLevelGrid&             a_eblgMGLev
                                           m_numPreCondIters,
                                           m_relaxType,
                                           m_alpha, m_beta,
-                                          m_ghostCellsPhi, m_ghostCellsRHS, s_testRef);
+                                          m_ghostCellsPhi, m_ghostCellsRHS, s_testRef, m_ncomp);
 
+  if ((a_whichLevel < m_boxCosts.size()) && !m_boxCosts[a_whichLevel].isNull() &&
+      (m_boxCosts[a_whichLevel]->getLayout() == a_eblgMGLevel.getDBL()))
+    {
+      op->setBoxCosts(m_boxCosts[a_whichLevel]);
+    }
 
   return op;
 }
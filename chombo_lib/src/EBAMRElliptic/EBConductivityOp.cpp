@@ -99,6 +99,7 @@ EBConductivityOp(const EBLevelGrid &                                  a_eblgFine
     m_fastFR(),
     m_hasMGObjects(a_hasMGObjects),
     m_layoutChanged(a_layoutChanged),
+    m_agglomeratedProc(EBAMRPoissonOp::getAgglomeratedProc(a_eblg.getDBL())),
     m_ebAverageMG(),
     m_ebInterpMG(),
     m_dblCoarMG(),
@@ -107,6 +108,9 @@ EBConductivityOp(const EBLevelGrid &                                  a_eblgFine
     m_colors()
 {
   CH_TIME("EBConductivityOp::ConductivityOp");
+#ifdef CH_MPI
+  m_comm = Chombo_MPI::comm;
+#endif
   int ncomp = 1;
 
   if (m_hasFine)
@@ -266,6 +270,7 @@ EBConductivityOp(const EBLevelGrid &                                  a_eblgFine
     m_fastFR(),
     m_hasMGObjects(a_hasMGObjects),
     m_layoutChanged(a_layoutChanged),
+    m_agglomeratedProc(EBAMRPoissonOp::getAgglomeratedProc(a_eblg.getDBL())),
     m_ebAverageMG(),
     m_ebInterpMG(),
     m_dblCoarMG(),
@@ -274,6 +279,9 @@ EBConductivityOp(const EBLevelGrid &                                  a_eblgFine
     m_colors()
 {
   CH_TIME("EBConductivityOp::ConductivityOp");
+#ifdef CH_MPI
+  m_comm = Chombo_MPI::comm;
+#endif
   int ncomp = 1;
   m_hasEBCF = false;
   if (m_hasFine)
@@ -349,6 +357,7 @@ EBConductivityOp(const EBLevelGrid &                                  a_eblgFine
   //flag for when we need special MG objects
   m_hasMGObjects = a_hasMGObjects;
   m_layoutChanged = a_layoutChanged;
+  m_agglomeratedProc = EBAMRPoissonOp::getAgglomeratedProc(m_eblg.getDBL());
   if (m_hasMGObjects)
     {
       int mgRef = 2;
@@ -1548,7 +1557,11 @@ dotProduct(const LevelData<EBCellFAB>& a_1,
   ProblemDomain domain;
   Real volume;
 
+#ifdef CH_MPI
+  return EBLevelDataOps::kappaDotProduct(volume,a_1,a_2,EBLEVELDATAOPS_ALLVOFS,domain,m_comm);
+#else
   return EBLevelDataOps::kappaDotProduct(volume,a_1,a_2,EBLEVELDATAOPS_ALLVOFS,domain);
+#endif
 }
 //-----------------------------------------------------------------------
 void
@@ -1598,7 +1611,7 @@ norm(const LevelData<EBCellFAB>& a_rhs,
 #ifdef CH_MPI
        Real tmp = 1.;
        int result = MPI_Allreduce(&maxNorm, &tmp, 1, MPI_CH_REAL,
-                         MPI_MAX, Chombo_MPI::comm);
+                         MPI_MAX, m_comm);
        if (result != MPI_SUCCESS)
          { //bark!!!
            MayDay::Error("sorry, but I had a communcation error on norm");
@@ -149,4 +149,86 @@ EBEllipticLoadBalance(Vector<int>&         a_procs,
 
   return retval;
 }
+///////////////
+void
+EBMeasuredLoads::
+define(const DisjointBoxLayout& a_grids)
+{
+  m_grids = a_grids;
+  m_costs.resize(a_grids.size());
+  m_isDefined = true;
+  clear();
+}
+///////////////
+void
+EBMeasuredLoads::
+clear()
+{
+  for (int ibox = 0; ibox < m_costs.size(); ibox++)
+    {
+      m_costs[ibox] = 0;
+    }
+  m_isMerged = false;
+}
+///////////////
+void
+EBMeasuredLoads::
+merge()
+{
+  CH_TIME("EBMeasuredLoads::merge");
+  CH_assert(m_isDefined);
+  if (m_isMerged) return;
+#ifdef CH_MPI
+  int count = m_costs.size();
+  if (count > 0)
+    {
+      Vector<unsigned long long> tmp(count);
+      MPI_Allreduce(&(m_costs[0]),&(tmp[0]), count, MPI_LONG_LONG_INT, MPI_SUM, Chombo_MPI::comm);
+      m_costs = tmp;
+    }
+#endif
+  m_isMerged = true;
+}
+///////////////
+Real
+EBMeasuredLoads::
+imbalance() const
+{
+  CH_assert(m_isDefined);
+  Vector<unsigned long long> procLoads(numProc(), 0);
+  unsigned long long totalLoad = 0;
+  int ibox = 0;
+  for (LayoutIterator lit = m_grids.layoutIterator(); lit.ok(); ++lit, ++ibox)
+    {
+      procLoads[m_grids.procID(lit())] += m_costs[ibox];
+      totalLoad                        += m_costs[ibox];
+    }
+  if (totalLoad == 0)
+    {
+      return 1.0;
+    }
+  unsigned long long maxLoad = 0;
+  for (int iproc = 0; iproc < procLoads.size(); iproc++)
+    {
+      maxLoad = Max(maxLoad, procLoads[iproc]);
+    }
+  Real meanLoad = Real(totalLoad)/Real(procLoads.size());
+  return Real(maxLoad)/meanLoad;
+}
+///////////////
+int
+EBMeasuredLoads::
+newProcs(Vector<int>& a_procs) const
+{
+  CH_TIME("EBMeasuredLoads::newProcs");
+  CH_assert(m_isDefined);
+  //a box nobody timed still has to go somewhere
+  Vector<unsigned long long> loads(m_costs.size());
+  for (int ibox = 0; ibox < loads.size(); ibox++)
+    {
+      loads[ibox] = m_costs[ibox] + 1;
+    }
+  Vector<Box> boxes = m_grids.boxArray();
+  return UnLongLongLoadBalance(a_procs, loads, boxes);
+}
 #include "NamespaceFooter.H"
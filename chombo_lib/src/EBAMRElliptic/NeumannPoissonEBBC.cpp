@@ -105,7 +105,8 @@ void NeumannPoissonEBBC::applyEBFluxPoint(const VolIndex&               a_vof,
                                           const RealVect&               a_dx,
                                           const Real&                   a_factor,
                                           const bool&                   a_useHomogeneous,
-                                          const Real&                   a_time)
+                                          const Real&                   a_time,
+                                          int                           a_comp)
 {
   Real flux = 0.0;
 
@@ -114,14 +115,14 @@ void NeumannPoissonEBBC::applyEBFluxPoint(const VolIndex&               a_vof,
 
   if (m_dataBased)
     {
-      flux = (*m_data)[a_dit](vof, 0);
+      flux = (*m_data)[a_dit](vof, a_comp);
     }
   else if (m_isFunction)
     {
       const RealVect& centroid = ebisBox.bndryCentroid(vof);
       const RealVect&   normal = ebisBox.normal(vof);
 
-      Real value = m_flux->value(vof,centroid,normal,a_dx,a_probLo,a_dit,a_time,0);
+      Real value = m_flux->value(vof,centroid,normal,a_dx,a_probLo,a_dit,a_time,a_comp);
       flux = -value;
     }
   else
@@ -149,7 +150,7 @@ void NeumannPoissonEBBC::applyEBFluxPoint(const VolIndex&               a_vof,
       BaseIVFAB<Real> baseivfabLph(ivsLph, ebgraph, 1);
 
       offset = baseivfabLph.getIndex(vof, 0) - baseivfabLph.dataPtr(0);
-      Real* multiValuedPtrLph = a_lphi.getMultiValuedFAB().dataPtr(0);
+      Real* multiValuedPtrLph = a_lphi.getMultiValuedFAB().dataPtr(a_comp);
       lphiPtr  = multiValuedPtrLph + offset;
     }
   else
@@ -162,7 +163,7 @@ void NeumannPoissonEBBC::applyEBFluxPoint(const VolIndex&               a_vof,
 #if CH_SPACEDIM==3
       offset +=  ivLph[2]*ncellsLph[0]*ncellsLph[1];
 #endif
-      Real* singleValuedPtrLph = a_lphi.getSingleValuedFAB().dataPtr();
+      Real* singleValuedPtrLph = a_lphi.getSingleValuedFAB().dataPtr(a_comp);
       lphiPtr  = singleValuedPtrLph + offset;
     }
   Real& lphi = *lphiPtr;
@@ -180,22 +181,26 @@ void NeumannPoissonEBBC::applyEBFlux(EBCellFAB&                    a_lphi,
                                      const Real&                   a_time)
 {
   CH_TIME("NeumannPoissonEBBC::applyEBFlux");
-  CH_assert(a_lphi.nComp() == 1 );
-  CH_assert(a_phi.nComp() == 1);
+  CH_assert(a_lphi.nComp() == a_phi.nComp());
+  CH_assert((!m_dataBased) || ((*m_data)[a_dit].nComp() >= a_phi.nComp()));
 
-  for (a_vofit.reset(); a_vofit.ok(); ++a_vofit)
+  for (int icomp = 0; icomp < a_phi.nComp(); icomp++)
     {
-      applyEBFluxPoint(a_vofit(),
-                       a_lphi,
-                       a_phi,
-                       a_vofit,
-                       a_cfivs,
-                       a_dit,
-                       a_probLo,
-                       a_dx,
-                       a_factor,
-                       a_useHomogeneous,
-                       a_time);
+      for (a_vofit.reset(); a_vofit.ok(); ++a_vofit)
+        {
+          applyEBFluxPoint(a_vofit(),
+                           a_lphi,
+                           a_phi,
+                           a_vofit,
+                           a_cfivs,
+                           a_dit,
+                           a_probLo,
+                           a_dx,
+                           a_factor,
+                           a_useHomogeneous,
+                           a_time,
+                           icomp);
+        }
     }
 }
 
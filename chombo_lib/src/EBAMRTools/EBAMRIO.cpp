@@ -16,6 +16,8 @@ using std::fstream;
 using std::string;
 #include <cstdio>
 #include <cmath>
+#include <list>
+#include <pthread.h>
 #include "CH_HDF5.H"
 #include "AMRIO.H"
 #include "EBAMRIO.H"
@@ -27,6 +29,7 @@ using std::string;
 #include "EBCellFactory.H"
 #include "VoFIterator.H"
 #include "VisItChomboDriver.H"
+#include "CH_Thread.H"
 #include "NamespaceHeader.H"
 
 #ifdef CH_USE_HDF5
@@ -34,6 +37,251 @@ using std::string;
 static int g_whichCellIndex = 0;
 static Real g_coveredCellValue = -98.7654321;
 
+///
+/**
+   One plotfile waiting to be written by the background writer.
+   Everything in here is owned by the job: the grids are built fresh
+   from the boxes and procs rather than copied, so no reference count is
+   shared with the solver's data while the writer thread uses them.
+*/
+class EBHDF5WriteJob
+{
+public:
+  EBHDF5WriteJob()
+  {
+  }
+
+  ~EBHDF5WriteJob()
+  {
+    for (int ilev = 0; ilev < m_data.size(); ilev++)
+      {
+        delete m_data[ilev];
+      }
+  }
+
+  void write()
+  {
+    WriteAMRHierarchyHDF5(m_filename, m_grids, m_data, m_names, m_domain,
+                          m_dx, m_dt, m_time, m_ratio, m_numLevels);
+  }
+
+  string                          m_filename;
+  Vector<DisjointBoxLayout>       m_grids;
+  Vector<LevelData<FArrayBox>* >  m_data;
+  Vector<string>                  m_names;
+  Box                             m_domain;
+  Real                            m_dx;
+  Real                            m_dt;
+  Real                            m_time;
+  Vector<int>                     m_ratio;
+  int                             m_numLevels;
+
+private:
+  EBHDF5WriteJob(const EBHDF5WriteJob& a_input)
+  {
+    MayDay::Error("invalid operator");
+  }
+  void operator=(const EBHDF5WriteJob& a_input)
+  {
+    MayDay::Error("invalid operator");
+  }
+};
+
+///
+/**
+   Bounded queue of plotfiles and the thread that writes them.
+   Finished jobs are handed back and deleted on the calling thread
+   so that all the allocation and freeing stays on thread 0.
+*/
+class EBHDF5AsyncWriter
+{
+public:
+  EBHDF5AsyncWriter()
+  {
+    m_async     = false;
+    m_maxDepth  = 2;
+    m_running   = false;
+    m_stop      = false;
+    m_writing   = false;
+    pthread_mutex_init(&m_mutex, NULL);
+    pthread_cond_init(&m_cond, NULL);
+  }
+
+  ~EBHDF5AsyncWriter()
+  {
+    stop();
+    pthread_cond_destroy(&m_cond);
+    pthread_mutex_destroy(&m_mutex);
+  }
+
+  void setAsync(bool a_async, int a_maxDepth)
+  {
+    CH_assert(a_maxDepth > 0);
+#ifdef CH_MPI
+    a_async = false;
+#endif
+    if (!a_async)
+      {
+        stop();
+      }
+    else if (!m_running)
+      {
+        m_stop = false;
+        if (pthread_create(&m_thread, NULL, EBHDF5AsyncWriter::threadEntry, this) != 0)
+          {
+            MayDay::Error("EBHDF5AsyncWriter: could not start the writer thread");
+          }
+        m_running = true;
+      }
+    m_async    = a_async;
+    m_maxDepth = a_maxDepth;
+  }
+
+  bool isAsync() const
+  {
+    return m_async;
+  }
+
+  ///takes ownership of a_job.  blocks while the queue is full.
+  void push(EBHDF5WriteJob* a_job)
+  {
+    CH_assert(m_running);
+    pthread_mutex_lock(&m_mutex);
+    while ((int)m_queue.size() >= m_maxDepth)
+      {
+        pthread_cond_wait(&m_cond, &m_mutex);
+      }
+    m_queue.push_back(a_job);
+    pthread_cond_broadcast(&m_cond);
+    pthread_mutex_unlock(&m_mutex);
+    reap();
+  }
+
+  ///wait for the queue to drain
+  void flush()
+  {
+    if (m_running)
+      {
+        pthread_mutex_lock(&m_mutex);
+        while (!m_queue.empty() || m_writing)
+          {
+            pthread_cond_wait(&m_cond, &m_mutex);
+          }
+        pthread_mutex_unlock(&m_mutex);
+      }
+    reap();
+  }
+
+protected:
+
+  void stop()
+  {
+    if (m_running)
+      {
+        flush();
+        pthread_mutex_lock(&m_mutex);
+        m_stop = true;
+        pthread_cond_broadcast(&m_cond);
+        pthread_mutex_unlock(&m_mutex);
+        pthread_join(m_thread, NULL);
+        m_running = false;
+      }
+    m_async = false;
+  }
+
+  ///delete finished jobs
+  void reap()
+  {
+    std::list<EBHDF5WriteJob*> done;
+    pthread_mutex_lock(&m_mutex);
+    done.swap(m_done);
+    pthread_mutex_unlock(&m_mutex);
+    for (std::list<EBHDF5WriteJob*>::iterator it = done.begin(); it != done.end(); ++it)
+      {
+        delete *it;
+      }
+  }
+
+  static void* threadEntry(void* a_writer)
+  {
+    static_cast<EBHDF5AsyncWriter*>(a_writer)->run();
+    return NULL;
+  }
+
+  void run()
+  {
+    setHelperThread(true);
+    pthread_mutex_lock(&m_mutex);
+    while (true)
+      {
+        while (m_queue.empty() && !m_stop)
+          {
+            pthread_cond_wait(&m_cond, &m_mutex);
+          }
+        if (m_queue.empty())
+          {
+            break;
+          }
+        EBHDF5WriteJob* job = m_queue.front();
+        m_queue.pop_front();
+        m_writing = true;
+        pthread_cond_broadcast(&m_cond);
+        pthread_mutex_unlock(&m_mutex);
+
+        job->write();
+
+        pthread_mutex_lock(&m_mutex);
+        m_done.push_back(job);
+        m_writing = false;
+        pthread_cond_broadcast(&m_cond);
+      }
+    pthread_mutex_unlock(&m_mutex);
+    setHelperThread(false);
+  }
+
+  bool                        m_async;
+  int                         m_maxDepth;
+  bool                        m_running;
+  bool                        m_stop;
+  bool                        m_writing;
+  pthread_t                   m_thread;
+  pthread_mutex_t             m_mutex;
+  pthread_cond_t              m_cond;
+  std::list<EBHDF5WriteJob*>  m_queue;
+  std::list<EBHDF5WriteJob*>  m_done;
+
+private:
+  EBHDF5AsyncWriter(const EBHDF5AsyncWriter& a_input)
+  {
+    MayDay::Error("invalid operator");
+  }
+  void operator=(const EBHDF5AsyncWriter& a_input)
+  {
+    MayDay::Error("invalid operator");
+  }
+};
+
+static EBHDF5AsyncWriter s_asyncWriter;
+
+void
+setEBHDF5Async(bool a_async, int a_maxQueueDepth)
+{
+  s_asyncWriter.setAsync(a_async, a_maxQueueDepth);
+}
+
+bool
+isEBHDF5Async()
+{
+  return s_asyncWriter.isAsync();
+}
+
+void
+flushEBHDF5()
+{
+  CH_TIME("EBAMRIO::flushEBHDF5");
+  s_asyncWriter.flush();
+}
+
 void
 writeEBHDF5(const string& a_filename,
             const Vector<DisjointBoxLayout>& a_vectGrids,
@@ -415,6 +663,42 @@ writeEBHDF5(const string& a_filename,
       }
     } //end loop over levels
 
+  if (s_asyncWriter.isAsync())
+    {
+      //move the data onto grids that only the job knows about and queue it
+      EBHDF5WriteJob* job = new EBHDF5WriteJob();
+      job->m_filename  = a_filename;
+      job->m_names     = names;
+      job->m_domain    = a_domain.domainBox();
+      job->m_dx        = a_dx;
+      job->m_dt        = a_dt;
+      job->m_time      = a_time;
+      job->m_ratio     = a_vectRatio;
+      job->m_numLevels = a_numLevels;
+      job->m_grids.resize(a_numLevels);
+      job->m_data.resize(a_numLevels, NULL);
+      for (int ilev = 0; ilev < a_numLevels; ilev++)
+        {
+          const DisjointBoxLayout& grids = a_vectGrids[ilev];
+          job->m_grids[ilev] = DisjointBoxLayout(grids.boxArray(), grids.procIDs(), grids.physDomain());
+          job->m_data[ilev]  = new LevelData<FArrayBox>(job->m_grids[ilev], ncompTotal, ghostIV);
+
+          //same boxes in the same order so the iterators march together
+          DataIterator dit = grids.dataIterator();
+          DataIterator jit = job->m_grids[ilev].dataIterator();
+          for (; dit.ok(); ++dit, ++jit)
+            {
+              (*job->m_data[ilev])[jit()].copy((*chomboData[ilev])[dit()]);
+            }
+          delete chomboData[ilev];
+        }
+      s_asyncWriter.push(job);
+      return;
+    }
+
+  //don't call HDF5 while the writer thread might be
+  flushEBHDF5();
+
   // write the data
   WriteAMRHierarchyHDF5(a_filename,
                         a_vectGrids,
@@ -173,6 +173,8 @@ defineDataHolders()
 
   BaseIVFactory<Real> factCedFine(m_ebislCedFine, m_setsCedFine);
   m_regsCedFine.define(m_gridsCedFine, m_nComp, m_redistRad*IntVect::Unit, factCedFine);
+  m_copierCoarToCedFine.define(m_gridsCoar, m_gridsCedFine, m_redistRad*IntVect::Unit);
+  m_copierCoarToCedFine.fixMessageSizes();
 
   EBCellFactory ebcellfact(m_ebislCedFine);
   m_densityCedFine.define(m_gridsCedFine, 1, 2*m_redistRad*IntVect::Unit, ebcellfact);
@@ -373,7 +375,7 @@ redistribute(LevelData<EBCellFAB>& a_fineSolution,
 {
   CH_TIME("EBCoarToFineRedist::redistribute");
   //copy the buffer to the fine layout
-  m_regsCoar.copyTo(a_variables, m_regsCedFine, a_variables);
+  m_regsCoar.copyTo(a_variables, m_regsCedFine, a_variables, m_copierCoarToCedFine);
   //redistribute the coarsened fine registers to the fine solution
   for (DataIterator dit = m_gridsFine.dataIterator(); dit.ok(); ++dit)
     {
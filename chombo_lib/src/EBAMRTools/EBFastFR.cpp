@@ -70,6 +70,7 @@ EBFastFR::setDefaultValues()
 {
   m_levelFluxReg = NULL;
   m_isDefined = false;
+  m_refluxPending = false;
   m_nComp = -1;
   m_refRat = -1;
 }
@@ -707,7 +708,41 @@ reflux(LevelData<EBCellFAB>& a_uCoar,
        bool a_multByKappaOneMinusKappa)
 {
   CH_TIME("EBFastFR::reflux");
+  refluxBegin(a_uCoar, a_variables, a_scale);
+  refluxEnd(a_uCoar, a_variables, a_scale, a_multByKappaOneMinusKappa);
+}
+/*******************/
+void
+EBFastFR::
+refluxBegin(LevelData<EBCellFAB>& a_uCoar,
+            const Interval&       a_variables,
+            const Real&           a_scale)
+{
+  CH_assert(m_isDefined);
+  CH_assert(!m_refluxPending);
+  CH_TIME("EBFastFR::refluxBegin");
+  //both sets of messages go out together and are waited on together
   LevelData<FArrayBox> uCoarLDF;
+  aliasEB(uCoarLDF, a_uCoar);
+  m_levelFluxReg->refluxBegin(uCoarLDF, a_variables, a_variables, a_scale);
+
+  if (m_hasEBCF)
+    {
+      EBAddOpEBFFR op;
+      m_delUCoFi.copyToBegin(a_variables, m_delUDiff, a_variables, m_reverseCopier, op);
+    }
+  m_refluxPending = true;
+}
+/*******************/
+void
+EBFastFR::
+refluxEnd(LevelData<EBCellFAB>& a_uCoar,
+          const Interval&       a_variables,
+          const Real&           a_scale,
+          bool a_multByKappaOneMinusKappa)
+{
+  CH_assert(m_refluxPending);
+  CH_TIME("EBFastFR::refluxEnd");
   //save initial values of ucoar because the non-eb flux  reg will
   //change it in its ignorance
   if (m_hasEBCF)
@@ -716,8 +751,9 @@ reflux(LevelData<EBCellFAB>& a_uCoar,
     }
 
   //reflux as if there were no EB
+  LevelData<FArrayBox> uCoarLDF;
   aliasEB(uCoarLDF, a_uCoar);
-  m_levelFluxReg->reflux(uCoarLDF, a_variables, a_variables, a_scale);
+  m_levelFluxReg->refluxEnd(uCoarLDF, a_variables, a_variables, a_scale);
 
   //correct at irregular cells
   if (m_hasEBCF)
@@ -726,6 +762,7 @@ reflux(LevelData<EBCellFAB>& a_uCoar,
 
       irregReflux(a_uCoar, a_variables, a_scale, a_multByKappaOneMinusKappa);
     }
+  m_refluxPending = false;
 }
 /*******************/
 void
@@ -742,12 +779,11 @@ irregReflux(LevelData<EBCellFAB>& a_uCoar,
       //coming into this routine, coar holds -coarFlux*area
       //and fine holds area*fineFlux
       //make diff = area(fineFlux-coarFlux)  (with scaling stuff)
-
-      EBLevelDataOps::setVal(m_delUDiff, 0.0);
-      m_delUCoar.copyTo(a_variables, m_delUDiff, a_variables);
+      //the fine part was sent by refluxBegin.
+      copyCoarRegister(a_variables);
 
       EBAddOpEBFFR op;
-      m_delUCoFi.copyTo(a_variables, m_delUDiff, a_variables, m_reverseCopier, op);
+      m_delUCoFi.copyToEnd(a_variables, m_delUDiff, a_variables, m_reverseCopier, op);
 
       //add refluxDivergence to solution u -= a_scale*(area*(fineFlux-coarFlux))
       incrementByRefluxDivergence(a_uCoar, m_delUDiff, a_variables, a_scale, false,
@@ -760,6 +796,22 @@ irregReflux(LevelData<EBCellFAB>& a_uCoar,
 /*******************/
 void
 EBFastFR::
+copyCoarRegister(const Interval& a_variables)
+{
+  CH_TIME("EBFastFR::copyCoarRegister");
+  //same layout, and only the valid cells are ever read, so no messages
+  CH_assert(m_delUCoar.disjointBoxLayout() == m_eblgCoar.getDBL());
+  CH_assert(m_delUDiff.disjointBoxLayout() == m_eblgCoar.getDBL());
+  for (DataIterator dit = m_eblgCoar.getDBL().dataIterator(); dit.ok(); ++dit)
+    {
+      const Box& grid = m_eblgCoar.getDBL()[dit()];
+      m_delUDiff[dit()].setVal(0.0);
+      m_delUDiff[dit()].copy(grid, a_variables, grid, m_delUCoar[dit()], a_variables);
+    }
+}
+/*******************/
+void
+EBFastFR::
 incrementByRefluxDivergence(LevelData<EBCellFAB>& a_uCoar,
                             LevelData<EBCellFAB>& a_delUDiff,
                             const Interval      & a_variables,
@@ -853,7 +905,20 @@ cacheOldSolution(const LevelData<EBCellFAB>& a_uCoar,
                  const Interval&             a_variables)
 {
   CH_TIME("EBFastFR::saveOldSolution");
-  a_uCoar.copyTo(a_variables, m_saveCoar, a_variables);
+  CH_assert(m_saveCoar.disjointBoxLayout() == m_eblgCoar.getDBL());
+  if (a_uCoar.disjointBoxLayout() == m_eblgCoar.getDBL())
+    {
+      //only the valid cells are restored, so this is a local copy
+      for (DataIterator dit = m_eblgCoar.getDBL().dataIterator(); dit.ok(); ++dit)
+        {
+          const Box& grid = m_eblgCoar.getDBL()[dit()];
+          m_saveCoar[dit()].copy(grid, a_variables, grid, a_uCoar[dit()], a_variables);
+        }
+    }
+  else
+    {
+      a_uCoar.copyTo(a_variables, m_saveCoar, a_variables);
+    }
 }
 /*******************/
 void
@@ -870,9 +935,7 @@ incrementDensityArray(LevelData<EBCellFAB>& a_coarDense,
       //coming into this routine, coarFlux holds -coarFlux*area
       //and fineFlux holds area*fineFlux
       //make fluxDiff = area(fineFlux-coarFlux)  (with scaling stuff)
-      EBLevelDataOps::setToZero(m_delUDiff);
-
-      m_delUCoar.copyTo(a_variables, m_delUDiff, a_variables);
+      copyCoarRegister(a_variables);
       EBAddOpEBFFR op;
 
       m_delUCoFi.copyTo(a_variables, m_delUDiff, a_variables, m_reverseCopier, op);
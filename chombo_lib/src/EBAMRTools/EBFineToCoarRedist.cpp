@@ -307,6 +307,8 @@ defineDataHolders()
 
     BaseIVFactory<Real> factRefCoar(m_ebislRefCoar, m_setsRefCoar);
     m_regsRefCoar.define(m_gridsRefCoar, m_nComp, m_redistRad*IntVect::Unit, factRefCoar);
+    m_copierFineToRefCoar.define(m_gridsFine, m_gridsRefCoar, m_redistRad*IntVect::Unit);
+    m_copierFineToRefCoar.fixMessageSizes();
   }
   //define the stencils with volume weights
   //use resetWeights to do anything different
@@ -409,7 +411,7 @@ redistribute(LevelData<EBCellFAB>& a_coarSolution,
   for (int idir = 0; idir < SpaceDim; idir++)
     nrefD *= m_refRat;
   //copy the buffer to the coarse layout
-  m_regsFine.copyTo(a_variables, m_regsRefCoar, a_variables);
+  m_regsFine.copyTo(a_variables, m_regsRefCoar, a_variables, m_copierFineToRefCoar);
   //redistribute the refined coarse registers to the coarse solution
   int ibox = 0;
   for (DataIterator dit = m_gridsCoar.dataIterator(); dit.ok(); ++dit)
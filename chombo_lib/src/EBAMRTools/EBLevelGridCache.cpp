@@ -0,0 +1,131 @@
+#ifdef CH_LANG_CC
+/*
+ *      _______              __
+ *     / ___/ /  ___  __ _  / /  ___
+ *    / /__/ _ \/ _ \/  V \/ _ \/ _ \
+ *    \___/_//_/\___/_/_/_/_.__/\___/
+ *    Please refer to Copyright.txt, in Chombo's root directory.
+ */
+#endif
+
+#include "EBLevelGridCache.H"
+#include "CH_Timer.H"
+#include "NamespaceHeader.H"
+
+/****/
+EBLevelGridCache::
+EBLevelGridCache()
+{
+  m_isDefined = false;
+  m_ebisPtr   = NULL;
+}
+/****/
+EBLevelGridCache::
+~EBLevelGridCache()
+{
+}
+/****/
+void
+EBLevelGridCache::
+clear()
+{
+  m_isDefined = false;
+  m_ebisPtr   = NULL;
+  m_grids.resize(0);
+  m_ebisl.resize(0);
+  m_domains.resize(0);
+  m_refRatio.resize(0);
+  m_eblg.resize(0);
+  m_quadCFI.clear();
+}
+/****/
+void
+EBLevelGridCache::
+define(const Vector<DisjointBoxLayout>& a_grids,
+       const Vector<EBISLayout>&        a_ebisl,
+       const ProblemDomain&             a_coarsestDomain,
+       const Vector<int>&               a_refRatio,
+       const EBIndexSpace* const        a_ebisPtr)
+{
+  CH_TIME("EBLevelGridCache::define");
+  CH_assert(a_ebisl.size() >= a_grids.size());
+  CH_assert((a_grids.size() <= 1) || (a_refRatio.size() >= a_grids.size()-1));
+
+  clear();
+
+  int nlev = a_grids.size();
+  m_grids    = a_grids;
+  m_refRatio = a_refRatio;
+  m_ebisPtr  = a_ebisPtr;
+  m_ebisl.resize(nlev);
+  m_domains.resize(nlev);
+  m_eblg.resize(nlev);
+
+  ProblemDomain levelDomain = a_coarsestDomain;
+  for (int ilev = 0; ilev < nlev; ilev++)
+    {
+      m_ebisl[ilev]   = a_ebisl[ilev];
+      m_domains[ilev] = levelDomain;
+      m_eblg[ilev].define(m_grids[ilev], m_ebisl[ilev], levelDomain);
+
+      if (ilev < nlev-1)
+        {
+          levelDomain.refine(m_refRatio[ilev]);
+        }
+    }
+  m_isDefined = true;
+}
+/****/
+bool
+EBLevelGridCache::
+isCurrent(const Vector<DisjointBoxLayout>& a_grids,
+          const Vector<EBISLayout>&        a_ebisl,
+          const EBIndexSpace* const        a_ebisPtr) const
+{
+  if (!m_isDefined) return false;
+  if (a_ebisPtr != m_ebisPtr) return false;
+  if (a_grids.size() != m_grids.size()) return false;
+  if (a_ebisl.size() < a_grids.size()) return false;
+  for (int ilev = 0; ilev < a_grids.size(); ilev++)
+    {
+      //BoxLayout::operator== checks that these are the same layout
+      if (!(a_grids[ilev] == m_grids[ilev])) return false;
+      //and EBISLayout::operator== that the layouts were not refilled
+      if (!(a_ebisl[ilev] == m_ebisl[ilev])) return false;
+    }
+  return true;
+}
+/****/
+const Vector<RefCountedPtr<EBQuadCFInterp> >&
+EBLevelGridCache::
+getQuadCFInterp(int a_ncomp)
+{
+  CH_TIME("EBLevelGridCache::getQuadCFInterp");
+  CH_assert(m_isDefined);
+  CH_assert(a_ncomp > 0);
+
+  std::map<int, Vector<RefCountedPtr<EBQuadCFInterp> > >::iterator it = m_quadCFI.find(a_ncomp);
+  if (it != m_quadCFI.end())
+    {
+      return it->second;
+    }
+
+  Vector<RefCountedPtr<EBQuadCFInterp> >& quadCFI = m_quadCFI[a_ncomp];
+  quadCFI.resize(m_grids.size());
+  for (int ilev = 1; ilev < m_grids.size(); ilev++)
+    {
+      quadCFI[ilev] = RefCountedPtr<EBQuadCFInterp>
+        (new EBQuadCFInterp(m_grids[ilev],
+                            m_grids[ilev-1],
+                            m_ebisl[ilev],
+                            m_ebisl[ilev-1],
+                            m_domains[ilev-1],
+                            m_refRatio[ilev-1],
+                            a_ncomp,
+                            *(m_eblg[ilev].getCFIVS()),
+                            m_ebisPtr));
+    }
+  return quadCFI;
+}
+
+#include "NamespaceFooter.H"
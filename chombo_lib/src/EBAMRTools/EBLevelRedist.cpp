@@ -87,6 +87,7 @@ define(const DisjointBoxLayout& a_dbl,
   BaseIVFactory<Real> factory(m_ebisl, m_sets);
   IntVect ivghost = redistRad*IntVect::Unit;
   m_buffer.define(m_grids, m_ncomp, ivghost, factory);
+  m_buffer.fixExchangeSizes();
   setToZero();
 }
 /***********************/
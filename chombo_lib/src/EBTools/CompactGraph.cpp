@@ -0,0 +1,364 @@
+#ifdef CH_LANG_CC
+/*
+ *      _______              __
+ *     / ___/ /  ___  __ _  / /  ___
+ *    / /__/ _ \/ _ \/  V \/ _ \/ _ \
+ *    \___/_//_/\___/_/_/_/_.__/\___/
+ *    Please refer to Copyright.txt, in Chombo's root directory.
+ */
+#endif
+
+#include "CompactGraph.H"
+#include "BoxIterator.H"
+#include "MayDay.H"
+#include "EBArith.H"
+#include "NamespaceHeader.H"
+
+// clear() keeps the capacity, so swap with an empty vector as well
+template <class T> static void release(Vector<T>& a_vec)
+{
+  a_vec.clear();
+  std::vector<T>().swap(a_vec.stdVector());
+}
+
+/*******************************/
+CompactGraph::CompactGraph()
+  : m_isDefined(false)
+{
+}
+
+/*******************************/
+CompactGraph::~CompactGraph()
+{
+}
+
+/*******************************/
+void CompactGraph::clear()
+{
+  m_cells.clear();
+  release(m_firstVoF);
+  release(m_flags);
+  release(m_coarserNode);
+  release(m_arcStart);
+  release(m_arcs);
+  release(m_finerStart);
+  release(m_finerNodes);
+  m_isDefined = false;
+}
+
+/*******************************/
+void CompactGraph::define(const BaseFab<GraphNode>& a_graph)
+{
+  CH_TIME("CompactGraph::define");
+  clear();
+
+  const Box& region = a_graph.box();
+  m_cells.define(region, 1);
+
+  // count first so each array is allocated once
+  int numLists = 0;
+  int numVoFs  = 0;
+  int numArcs  = 0;
+  int numFiner = 0;
+  for (BoxIterator bit(region); bit.ok(); ++bit)
+    {
+      const GraphNode& node = a_graph(bit(), 0);
+      if (node.hasValidCellList())
+        {
+          const Vector<GraphNodeImplem>& nodes = *(node.m_cellList);
+          numLists++;
+          numVoFs += nodes.size();
+          for (int ivof = 0; ivof < nodes.size(); ivof++)
+            {
+              for (int iarc = 0; iarc < 2*SpaceDim; iarc++)
+                {
+                  numArcs += nodes[ivof].m_arc[iarc].size();
+                }
+              numFiner += nodes[ivof].m_finerNodes.size();
+            }
+        }
+    }
+
+  m_firstVoF.reserve(numLists + 1);
+  m_flags.reserve(numVoFs);
+  m_coarserNode.reserve(numVoFs);
+  m_arcStart.reserve(2*SpaceDim*numVoFs + 1);
+  m_arcs.reserve(numArcs);
+  m_finerStart.reserve(numVoFs + 1);
+  m_finerNodes.reserve(numFiner);
+
+  for (BoxIterator bit(region); bit.ok(); ++bit)
+    {
+      const IntVect& iv = bit();
+      const GraphNode& node = a_graph(iv, 0);
+      if (node.isCovered())
+        {
+          m_cells(iv, 0) = s_covered;
+        }
+      else if (node.isRegularWithSingleValuedParent())
+        {
+          m_cells(iv, 0) = s_regular;
+        }
+      else
+        {
+          m_cells(iv, 0) = m_firstVoF.size();
+          m_firstVoF.push_back(m_flags.size());
+
+          const Vector<GraphNodeImplem>& nodes = *(node.m_cellList);
+          for (int ivof = 0; ivof < nodes.size(); ivof++)
+            {
+              const GraphNodeImplem& implem = nodes[ivof];
+              unsigned char flags = 0;
+              if (implem.m_isRegular) flags |= s_isRegularBit;
+              if (implem.m_isValid)   flags |= s_isValidBit;
+              m_flags.push_back(flags);
+              m_coarserNode.push_back(implem.m_coarserNode);
+
+              for (int iarc = 0; iarc < 2*SpaceDim; iarc++)
+                {
+                  m_arcStart.push_back(m_arcs.size());
+                  m_arcs.append(implem.m_arc[iarc]);
+                }
+
+              m_finerStart.push_back(m_finerNodes.size());
+              for (int ifine = 0; ifine < implem.m_finerNodes.size(); ifine++)
+                {
+                  const VolIndex& fineVoF = implem.m_finerNodes[ifine];
+                  IntVect offset = fineVoF.gridIndex() - 2*iv;
+                  int packed = fineVoF.cellIndex();
+                  for (int idir = SpaceDim-1; idir >= 0; idir--)
+                    {
+                      if ((offset[idir] != 0) && (offset[idir] != 1))
+                        {
+                          MayDay::Error("CompactGraph: finer vof is not in the refined cell");
+                        }
+                      packed = 2*packed + offset[idir];
+                    }
+                  m_finerNodes.push_back(packed);
+                }
+            }
+        }
+    }
+  m_firstVoF.push_back(m_flags.size());
+  m_arcStart.push_back(m_arcs.size());
+  m_finerStart.push_back(m_finerNodes.size());
+
+  m_isDefined = true;
+}
+
+/*******************************/
+void CompactGraph::getNode(GraphNode&     a_node,
+                           const IntVect& a_iv) const
+{
+  CH_assert(m_isDefined);
+  int code = m_cells(a_iv, 0);
+  if (code == s_covered)
+    {
+      a_node.defineAsCovered();
+    }
+  else if (code == s_regular)
+    {
+      a_node.defineAsRegular();
+    }
+  else
+    {
+      a_node.clear();
+      a_node.m_cellList = new(a_node.alloc()) Vector<GraphNodeImplem>(m_firstVoF[code+1] - m_firstVoF[code]);
+      Vector<GraphNodeImplem>& nodes = *(a_node.m_cellList);
+      for (int ivof = m_firstVoF[code]; ivof < m_firstVoF[code+1]; ivof++)
+        {
+          GraphNodeImplem& implem = nodes[ivof - m_firstVoF[code]];
+          implem.m_isRegular   = ((m_flags[ivof] & s_isRegularBit) != 0);
+          implem.m_isValid     = ((m_flags[ivof] & s_isValidBit) != 0);
+          implem.m_coarserNode = m_coarserNode[ivof];
+
+          for (int iarc = 0; iarc < 2*SpaceDim; iarc++)
+            {
+              int start = m_arcStart[2*SpaceDim*ivof + iarc];
+              int end   = m_arcStart[2*SpaceDim*ivof + iarc + 1];
+              Vector<int>& arcs = implem.m_arc[iarc];
+              arcs.resize(end - start);
+              for (int ia = start; ia < end; ia++)
+                {
+                  arcs[ia - start] = m_arcs[ia];
+                }
+            }
+
+          int start = m_finerStart[ivof];
+          int end   = m_finerStart[ivof + 1];
+          implem.m_finerNodes.resize(end - start);
+          for (int ifine = start; ifine < end; ifine++)
+            {
+              int packed = m_finerNodes[ifine];
+              IntVect ivFine = 2*a_iv;
+              for (int idir = 0; idir < SpaceDim; idir++)
+                {
+                  ivFine[idir] += (packed & 1);
+                  packed >>= 1;
+                }
+              implem.m_finerNodes[ifine - start] = VolIndex(ivFine, packed);
+            }
+        }
+    }
+}
+
+/*******************************/
+void CompactGraph::fill(BaseFab<GraphNode>& a_graph,
+                        const Box&          a_region) const
+{
+  CH_TIME("CompactGraph::fill");
+  CH_assert(m_isDefined);
+  CH_assert(box().contains(a_region));
+  CH_assert(a_graph.box().contains(a_region));
+  for (BoxIterator bit(a_region); bit.ok(); ++bit)
+    {
+      getNode(a_graph(bit(), 0), bit());
+    }
+}
+
+/*******************************/
+Vector<VolIndex> CompactGraph::getVoFs(const IntVect& a_iv) const
+{
+  int nvofs = size(a_iv);
+  Vector<VolIndex> retvec(nvofs);
+  for (int ivof = 0; ivof < nvofs; ivof++)
+    {
+      retvec[ivof] = VolIndex(a_iv, ivof);
+    }
+  return retvec;
+}
+
+/*******************************/
+void CompactGraph::addFaces(Vector<FaceIndex>&    a_faces,
+                            const VolIndex&       a_vof,
+                            const int&            a_ivof,
+                            const int&            a_idir,
+                            const Side::LoHiSide& a_sd) const
+{
+  IntVect otherIV = a_vof.gridIndex() + sign(a_sd)*BASISV(a_idir);
+  int iarc  = a_idir + a_sd*SpaceDim;
+  int start = m_arcStart[2*SpaceDim*a_ivof + iarc];
+  int end   = m_arcStart[2*SpaceDim*a_ivof + iarc + 1];
+  for (int ia = start; ia < end; ia++)
+    {
+      a_faces.push_back(FaceIndex(a_vof, VolIndex(otherIV, m_arcs[ia]), a_idir));
+    }
+}
+
+/*******************************/
+Vector<FaceIndex> CompactGraph::getFaces(const VolIndex&       a_vof,
+                                         const int&            a_idir,
+                                         const Side::LoHiSide& a_sd,
+                                         const ProblemDomain&  a_domain) const
+{
+  Vector<FaceIndex> retvec;
+  const IntVect& iv = a_vof.gridIndex();
+  if (isRegular(iv))
+    {
+      // if the cell is regular, the other cell must be single valued
+      IntVect otherIV = iv + sign(a_sd)*BASISV(a_idir);
+      int otherCellIndex = 0;
+      if (!a_domain.contains(otherIV))
+        {
+          otherCellIndex = -1;
+        }
+      retvec.push_back(FaceIndex(a_vof, VolIndex(otherIV, otherCellIndex), a_idir));
+    }
+  else if (!isCovered(iv))
+    {
+      CH_assert(a_vof.cellIndex() >= 0 && a_vof.cellIndex() < size(iv));
+      addFaces(retvec, a_vof, firstVoF(iv) + a_vof.cellIndex(), a_idir, a_sd);
+    }
+  return retvec;
+}
+
+/*******************************/
+Vector<FaceIndex> CompactGraph::getFaces(const IntVect&        a_iv,
+                                         const int&            a_idir,
+                                         const Side::LoHiSide& a_sd,
+                                         const ProblemDomain&  a_domain) const
+{
+  if (isRegular(a_iv) || isCovered(a_iv))
+    {
+      return getFaces(VolIndex(a_iv, 0), a_idir, a_sd, a_domain);
+    }
+  Vector<FaceIndex> retvec;
+  int first = firstVoF(a_iv);
+  int nvofs = size(a_iv);
+  for (int ivof = 0; ivof < nvofs; ivof++)
+    {
+      addFaces(retvec, VolIndex(a_iv, ivof), first + ivof, a_idir, a_sd);
+    }
+  return retvec;
+}
+
+/*******************************/
+Vector<VolIndex> CompactGraph::refine(const VolIndex& a_coarVoF) const
+{
+  Vector<VolIndex> retvec;
+  const IntVect& iv = a_coarVoF.gridIndex();
+  if (isCovered(iv))
+    {
+      //return empty vector
+    }
+  else if (isRegular(iv))
+    {
+      Box refbox = ebrefine(Box(iv,iv),2);
+      for (BoxIterator bit(refbox); bit.ok(); ++bit)
+        {
+          retvec.push_back(VolIndex(bit(), 0));
+        }
+    }
+  else
+    {
+      CH_assert(a_coarVoF.cellIndex() >= 0 && a_coarVoF.cellIndex() < size(iv));
+      int ivof  = firstVoF(iv) + a_coarVoF.cellIndex();
+      int start = m_finerStart[ivof];
+      int end   = m_finerStart[ivof + 1];
+      retvec.resize(end - start);
+      for (int ifine = start; ifine < end; ifine++)
+        {
+          int packed = m_finerNodes[ifine];
+          IntVect ivFine = 2*iv;
+          for (int idir = 0; idir < SpaceDim; idir++)
+            {
+              ivFine[idir] += (packed & 1);
+              packed >>= 1;
+            }
+          retvec[ifine - start] = VolIndex(ivFine, packed);
+        }
+    }
+  return retvec;
+}
+
+/*******************************/
+VolIndex CompactGraph::coarsen(const VolIndex& a_fineVoF) const
+{
+  const IntVect& iv = a_fineVoF.gridIndex();
+  int cellIndexCoar = 0;
+  int code = m_cells(iv, 0);
+  if (code >= 0)
+    {
+      // regular with a multivalued parent has its one vof in the list too
+      int ivof = m_firstVoF[code];
+      if ((m_flags[ivof] & s_isRegularBit) == 0)
+        {
+          ivof += a_fineVoF.cellIndex();
+        }
+      cellIndexCoar = m_coarserNode[ivof];
+    }
+  return VolIndex(ebcoarsen(iv, 2), cellIndexCoar);
+}
+
+/*******************************/
+long long CompactGraph::memory() const
+{
+  long long bytes = sizeof(int)*(long long)(m_cells.box().numPts());
+  bytes += sizeof(int)*(long long)(m_firstVoF.size() + m_coarserNode.size()
+                                   + m_arcStart.size() + m_arcs.size()
+                                   + m_finerStart.size() + m_finerNodes.size());
+  bytes += m_flags.size();
+  return bytes;
+}
+
+#include "NamespaceFooter.H"
@@ -137,6 +137,7 @@ void EBGraphImplem::addEmptyIrregularVoFs(const IntVectSet& a_vofsToChange)
       //this is all supposed to be called for covered vofs
       //to be changed to empty irregular vofs
       CH_assert(!isAllRegular());
+      expand();
       if (isAllCovered())
         {
           m_tag = HasIrregular;
@@ -204,6 +205,7 @@ void EBGraphImplem::addFullIrregularVoFs(const IntVectSet& a_vofsToChange,
       //this is all supposed to be called for regular vofs
       //to be changed to full irregular vofs
       CH_assert(!isAllCovered());
+      expand();
       if (isAllRegular())
         {
           m_tag = HasIrregular;
@@ -315,6 +317,7 @@ void EBGraphImplem::setToAllRegular()
   if (m_multiIVS != NULL) delete m_multiIVS;
   m_irregIVS = NULL;
   m_multiIVS = NULL;
+  m_compact.clear();
 }
 
 /*******************************/
@@ -327,6 +330,7 @@ void EBGraphImplem::setToAllCovered()
   if (m_multiIVS != NULL) delete m_multiIVS;
   m_irregIVS = NULL;
   m_multiIVS = NULL;
+  m_compact.clear();
 }
 
 /*******************************/
@@ -526,7 +530,7 @@ void EBGraphImplem::buildGraph(const BaseFab<int>&      a_regIrregCovered,
   define(a_validRegion);
   setDomain(a_domain);
 
-  //remember that this forces a dense representation.
+  //the sets start out dense and are compressed once they are filled.
   m_tag = HasIrregular;
   if (m_irregIVS != NULL) delete m_irregIVS;
   if (m_multiIVS != NULL) delete m_multiIVS;
@@ -630,6 +634,32 @@ void EBGraphImplem::buildGraph(const BaseFab<int>&      a_regIrregCovered,
         }
 
     }
+  // on big boxes the irregular cells are far fewer than the bits
+  m_irregIVS->compress();
+  m_multiIVS->compress();
+}
+
+/*******************************/
+void EBGraphImplem::compact()
+{
+  CH_TIME("EBGraphImplem::compact");
+  if (hasIrregular() && !isCompact())
+    {
+      m_compact.define(m_graph);
+      m_graph.clear();
+    }
+}
+
+/*******************************/
+void EBGraphImplem::expand()
+{
+  CH_TIME("EBGraphImplem::expand");
+  if (isCompact())
+    {
+      m_graph.define(m_compact.box(), 1);
+      m_compact.fill(m_graph, m_compact.box());
+      m_compact.clear();
+    }
 }
 
 /*******************************/
@@ -664,6 +694,7 @@ void EBGraphImplem::define(const Box& a_region)
   m_multiIVS = NULL;
   m_mask.clear();
   m_isMaskBuilt = false;
+  m_compact.clear();
   m_isDefined= true;
 }
 
@@ -744,8 +775,15 @@ Vector<VolIndex> EBGraphImplem::getVoFs(const IntVect& a_iv) const
     {
       CH_assert(m_region.contains(a_iv));
       CH_assert(m_domain.contains(a_iv));
-      const GraphNode& node = m_graph(a_iv, 0);
-      retvec = node.getVoFs(a_iv);
+      if (isCompact())
+        {
+          retvec = m_compact.getVoFs(a_iv);
+        }
+      else
+        {
+          const GraphNode& node = m_graph(a_iv, 0);
+          retvec = node.getVoFs(a_iv);
+        }
     }
   return retvec;
 }
@@ -768,8 +806,15 @@ bool EBGraphImplem::isRegular(const IntVect& a_iv) const
     {
       //CH_assert(m_region.contains(a_iv)); //picked up my m_graph already
       //CH_assert(m_domain.contains(a_iv));
-      const GraphNode& node = m_graph(a_iv, 0);
-      retval = node.isRegular();
+      if (isCompact())
+        {
+          retval = m_compact.isRegular(a_iv);
+        }
+      else
+        {
+          const GraphNode& node = m_graph(a_iv, 0);
+          retval = node.isRegular();
+        }
     }
   else
     {
@@ -811,8 +856,15 @@ bool EBGraphImplem::isIrregular(const IntVect& a_iv) const
     {
       CH_assert(m_region.contains(a_iv));
       CH_assert(m_domain.contains(a_iv));
-      const GraphNode& node = m_graph(a_iv, 0);
-      retval = node.isIrregular();
+      if (isCompact())
+        {
+          retval = m_compact.isIrregular(a_iv);
+        }
+      else
+        {
+          const GraphNode& node = m_graph(a_iv, 0);
+          retval = node.isIrregular();
+        }
     }
   else
     {
@@ -844,9 +896,14 @@ int EBGraphImplem::size(const Box&      a_region,
   int linearSize = sizeof(int);
   if (!isRegular(a_region) && !isCovered(a_region))
     {
+      GraphNode compactNode;
       for (BoxIterator bit(a_region); bit.ok(); ++bit)
         {
-          const GraphNode& node = m_graph(bit(), 0);
+          if (isCompact())
+            {
+              m_compact.getNode(compactNode, bit());
+            }
+          const GraphNode& node = isCompact() ? compactNode : m_graph(bit(), 0);
           int nodeSize = node.linearSize();
           linearSize += nodeSize;
         }
@@ -883,9 +940,14 @@ void EBGraphImplem::linearOut(void*           a_buf,
   if (!isRegular(a_region) && !isCovered(a_region))
     {
       unsigned char* buffer = (unsigned char*) intbuf;
+      GraphNode compactNode;
       for (BoxIterator bit(a_region); bit.ok(); ++bit)
         {
-          const GraphNode& node = m_graph(bit(), 0);
+          if (isCompact())
+            {
+              m_compact.getNode(compactNode, bit());
+            }
+          const GraphNode& node = isCompact() ? compactNode : m_graph(bit(), 0);
           int nodeSize = node.linearSize();
           node.linearOut(buffer);
           buffer += nodeSize;
@@ -903,6 +965,7 @@ void EBGraphImplem::linearIn(void*           a_buf,
   CH_assert(isDomainSet());
   CH_assert(isDefined());
   CH_assert(isDomainSet());
+  expand();
   int* intbuf = (int*) a_buf;
   int secretCode = *intbuf;
   intbuf++;
@@ -981,8 +1044,15 @@ bool EBGraphImplem::isCovered(const IntVect& a_iv) const
     {
       //CH_assert(m_region.contains(a_iv)); this check picked up by m_graph
       //CH_assert(m_domain.contains(a_iv));
-      const GraphNode& node = m_graph(a_iv, 0);
-      retval = node.isCovered();
+      if (isCompact())
+        {
+          retval = m_compact.isCovered(a_iv);
+        }
+      else
+        {
+          const GraphNode& node = m_graph(a_iv, 0);
+          retval = node.isCovered();
+        }
     }
   else
     {
@@ -1095,9 +1165,16 @@ Vector<FaceIndex> EBGraphImplem::getFaces(const VolIndex&       a_vof,
     }
   else if (m_tag == HasIrregular)
     {
-      const IntVect& iv = a_vof.gridIndex();
-      const GraphNode& node = m_graph(iv, 0);
-      retvec = node.getFaces(a_vof, a_idir, a_sd, m_domain);
+      if (isCompact())
+        {
+          retvec = m_compact.getFaces(a_vof, a_idir, a_sd, m_domain);
+        }
+      else
+        {
+          const IntVect& iv = a_vof.gridIndex();
+          const GraphNode& node = m_graph(iv, 0);
+          retvec = node.getFaces(a_vof, a_idir, a_sd, m_domain);
+        }
     }
 
   return retvec;
@@ -1120,14 +1197,14 @@ void EBGraph::fillIntMask(BaseFab<int>& a_mask) const
 
 void EBGraphImplem::fillMask(BaseFab<char>& a_mask) const
 {
-  Box b = a_mask.box() & m_graph.box();
+  Box b = a_mask.box() & graphBox();
   if (b.isEmpty()) return;
   BoxIterator bit(b);
   for (; bit.ok(); ++bit)
     {
-      const GraphNode& g = m_graph(bit(), 0);
-      CH_assert(g.size() < 128);
-      a_mask(bit(), 0) = (char)(g.size());
+      int nvofs = isCompact() ? m_compact.size(bit()) : m_graph(bit(), 0).size();
+      CH_assert(nvofs < 128);
+      a_mask(bit(), 0) = (char)(nvofs);
     }
 }
 
@@ -1186,7 +1263,7 @@ void EBGraphImplem::fillCellTypeMask(BaseFab<char>& a_mask) const
     }
   else
     {
-      Box b = a_mask.box() & m_graph.box();
+      Box b = a_mask.box() & graphBox();
       if (b.isEmpty()) return;
       for (BoxIterator bit(b); bit.ok(); ++bit)
         {
@@ -1232,12 +1309,18 @@ Vector<FaceIndex>  EBGraphImplem::getIrregFaces(const Box& a_box,
       IntVectSet ivs = this->getIrregCells(b);
       for (IVSIterator it(ivs); it.ok(); ++it)
         {
-          const GraphNode& node = m_graph(it(), 0);
           IntVect hi = it() + BASISV(a_dir);
-          CH_assert(node.isIrregular());
-          if (b.contains(hi) && m_graph(hi, 0).isIrregular())
+          CH_assert(isIrregular(it()));
+          if (b.contains(hi) && isIrregular(hi))
           {
-            faces.append(node.getFaces(it(), a_dir, Side::Hi, m_domain));
+            if (isCompact())
+              {
+                faces.append(m_compact.getFaces(it(), a_dir, Side::Hi, m_domain));
+              }
+            else
+              {
+                faces.append(m_graph(it(), 0).getFaces(it(), a_dir, Side::Hi, m_domain));
+              }
           }
         }
     }
@@ -1434,9 +1517,16 @@ VolIndex EBGraphImplem::coarsen(const VolIndex& a_fineVoF) const
   else
     {
       CH_assert(m_tag == HasIrregular);
-      const IntVect& iv = a_fineVoF.gridIndex();
-      const GraphNode& node = m_graph(iv, 0);
-      retval = node.coarsen(a_fineVoF);
+      if (isCompact())
+        {
+          retval = m_compact.coarsen(a_fineVoF);
+        }
+      else
+        {
+          const IntVect& iv = a_fineVoF.gridIndex();
+          const GraphNode& node = m_graph(iv, 0);
+          retval = node.coarsen(a_fineVoF);
+        }
     }
   return retval;
 }
@@ -1473,6 +1563,10 @@ Vector<VolIndex> EBGraphImplem::refine(const VolIndex& a_coarVoF) const
           pout() << "tag is all covered" << endl;
         }
     }
+  else if (isCompact())
+    {
+      retval = m_compact.refine(a_coarVoF);
+    }
   else
     {
       CH_assert(m_tag == HasIrregular);
@@ -1507,6 +1601,7 @@ void EBGraphImplem::copy(const Box&           a_regionFrom,
   CH_TIME("EBGraphImplem::copy");
   CH_assert(isDefined());
   CH_assert(isDomainSet());
+  expand();
   if (isRegular(a_regionTo) && a_source.isRegular(a_regionFrom))
     {
       return;
@@ -1572,7 +1667,13 @@ void EBGraphImplem::copy(const Box&           a_regionFrom,
       //see if we need to generate a source fab
       BaseFab<GraphNode>* srcFabPtr;
       bool needToDelete;
-      if (a_source.hasIrregular())
+      if (a_source.isCompact())
+        {
+          needToDelete = true;
+          srcFabPtr = new BaseFab<GraphNode>(a_regionFrom, 1);
+          a_source.m_compact.fill(*srcFabPtr, a_regionFrom);
+        }
+      else if (a_source.hasIrregular())
         {
           srcFabPtr = (BaseFab<GraphNode>*)&a_source.m_graph;
           needToDelete = false;
@@ -1647,6 +1748,7 @@ void EBGraphImplem::coarsenVoFs(const EBGraphImplem& a_fineGraph,
   CH_TIME("EBGraphImplem::coarsenVoFs");
 
   //this also defines the boxes
+  m_compact.clear();
   m_region = a_coarRegion;
   m_domain = ebcoarsen(a_fineGraph.getDomain(), 2);
   m_isDomainSet = true;
@@ -1717,6 +1819,8 @@ void EBGraphImplem::coarsenVoFs(const EBGraphImplem& a_fineGraph,
             }
         }
       if (numCoarVoFs > numFineVoFs) MayDay::Error("Coarsening generated more VoFs");
+      m_irregIVS->compress();
+      m_multiIVS->compress();
     }
 }
 
@@ -1873,6 +1977,7 @@ void EBGraphImplem::coarsenFaces(const EBGraphImplem& a_coarGhostGraph,
 
   if (hasIrregular())
     {
+      expand();
       CH_assert(a_coarGhostGraph.getDomain() == m_domain);
       for (BoxIterator bit(m_region); bit.ok(); ++bit)
         {
@@ -1910,16 +2015,14 @@ void EBGraphImplem::fixFineToCoarse(EBGraphImplem& a_fineGraph) const
 {
   if (hasIrregular())
     {
+      a_fineGraph.expand();
       for (BoxIterator bit(m_region); bit.ok(); ++bit)
         {
           if (isIrregular(bit()))
             {
               const IntVect& ivCoar = bit();
 
-              const Vector<GraphNodeImplem>&
-                vofsCoar = *(m_graph(ivCoar, 0).m_cellList);
-
-              int numVofsCoar = vofsCoar.size();
+              int numVofsCoar = numVoFs(ivCoar);
 
               for (int icoar = 0; icoar < numVofsCoar; icoar++)
                 {
@@ -1975,7 +2078,7 @@ long long EBGraphImplem::numVoFs(const IntVect& a_iv) const
     {
       CH_assert(m_region.contains(a_iv));
       CH_assert(m_domain.contains(a_iv));
-      count = m_graph(a_iv, 0).size();
+      count = isCompact() ? m_compact.size(a_iv) : m_graph(a_iv, 0).size();
     }
   return count;
 }
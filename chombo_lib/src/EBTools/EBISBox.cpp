@@ -54,7 +54,7 @@ IntVectSet EBISBox::boundaryIVS(const Box& a_subbox) const
 {
   IntVectSet ivs = getIrregIVS(a_subbox);
   IntVectSet rtn = ivs;
-  CH_assert(rtn.isDense());
+  CH_assert(rtn.isDense() || rtn.isRun());
   IVSIterator it(ivs);
   for (;it.ok(); ++it)
   {
@@ -44,6 +44,13 @@ void EBISLayoutImplem::setVerbose(bool a_verbose)
   s_verbose = a_verbose;
 }
 /****************/
+bool EBISLayoutImplem::s_compactGraphs = false;
+/****************/
+void EBISLayoutImplem::setCompactGraphs(bool a_compactGraphs)
+{
+  s_compactGraphs = a_compactGraphs;
+}
+/****************/
 void
 EBISLayout::define(const ProblemDomain& a_domain,
                    const DisjointBoxLayout& a_grids,
@@ -56,6 +63,17 @@ EBISLayout::define(const ProblemDomain& a_domain,
 }
 /****************/
 void
+EBISLayout::define(const EBISLayout& a_ebisl,
+                   const int&        a_nghost)
+{
+  CH_assert(a_ebisl.isDefined());
+  CH_assert(a_nghost >= 0);
+  CH_assert(a_nghost <= a_ebisl.getGhost());
+  m_implem = a_ebisl.m_implem;
+  m_nghost = a_nghost;
+}
+/****************/
+void
 EBISLayoutImplem::define(const ProblemDomain& a_domain,
                          const DisjointBoxLayout& a_grids,
                          const int& a_nghost,
@@ -63,9 +81,6 @@ EBISLayoutImplem::define(const ProblemDomain& a_domain,
                          const LevelData<EBData> & a_data)
 {
   CH_TIME("EBISLayoutImplem::define");
-#ifdef CH_MPI
-    MPI_Barrier(Chombo_MPI::comm);
-#endif
   m_domain = a_domain;
   m_nghost = a_nghost;
   m_dblInputDom = a_grids;
@@ -136,6 +151,10 @@ EBISLayoutImplem::define(const ProblemDomain& a_domain,
   m_ebisBoxes.define(m_blGhostDom);
   for (DataIterator dit= a_grids.dataIterator(); dit.ok(); ++dit)
     {
+      if (s_compactGraphs)
+        {
+          localGraph[dit()].compact();
+        }
       const EBGraph& graphlocal = localGraph[dit()];
       Box graphregion=  graphlocal.getRegion();
       m_ebisBoxes[dit()].define(localGraph[dit()], localData[dit()]);
@@ -17,6 +17,7 @@
 #include "LayoutIterator.H"
 #include "BRMeshRefine.H"
 #include "AMRIO.H"
+#include "ClockTicks.H"
 
 #include "EBCFCopy.H"
 #include "EBISLevel.H"
@@ -55,6 +56,7 @@ void Chombo_EBIS::alias(const EBIndexSpace* a_input)
 Real EBISLevel::s_tolerance = 1.0e-12;
 bool EBISLevel::s_verbose   = false;
 bool EBISLevel::s_recursive = false;
+Real EBISLevel::s_rebalanceRatio = 1.25;
 
 long long EBISLevel::numVoFsOnProc() const
 {
@@ -334,18 +336,33 @@ EBISLevel::defineGraphFromGeo(LevelData<EBGraph>             & a_graph,
                               const ProblemDomain            & a_domain,
                               const RealVect                 & a_origin,
                               const Real                     & a_dx,
-                              const bool                     & a_distributedData)
+                              const bool                     & a_distributedData,
+                              LayoutData<unsigned long long> * a_boxCost)
 {
+  CH_TIME("EBISLevel::defineGraphFromGeo");
+
+  //boxes cost anything from nothing (regular, covered) to root finding in
+  //every cell, so threads take the next box as they finish one
+  DataIterator dit = a_grids.dataIterator();
+  int nbox = dit.size();
+  bool threaded = a_geoserver.isThreadSafe();
+  //statics fillGraph depends on are set here, not from every thread
+  a_geoserver.prepareFillGraph(a_dx);
+
   //define the graph stuff
-  for (DataIterator dit = a_grids.dataIterator(); dit.ok(); ++dit)
+#pragma omp parallel for schedule(dynamic,1) if(threaded)
+  for (int ibox = 0; ibox < nbox; ibox++)
     {
-      Box region = a_grids.get(dit());
+      const DataIndex di = dit[ibox];
+      unsigned long long start = ch_ticks();
+
+      Box region = a_grids.get(di);
       region.grow(1);
       Box ghostRegion = grow(region,1);
       ghostRegion &= a_domain;
       region &= a_domain;
 
-      EBGraph& ebgraph = a_graph[dit()];
+      EBGraph& ebgraph = a_graph[di];
       GeometryService::InOut inout;
       if (!a_distributedData)
         {
@@ -353,7 +370,7 @@ EBISLevel::defineGraphFromGeo(LevelData<EBGraph>             & a_graph,
         }
       else
         {
-          inout = a_geoserver.InsideOutside(region, a_domain, a_origin, a_dx, dit());
+          inout = a_geoserver.InsideOutside(region, a_domain, a_origin, a_dx, di);
         }
       if (inout == GeometryService::Regular)
         {
@@ -366,7 +383,7 @@ EBISLevel::defineGraphFromGeo(LevelData<EBGraph>             & a_graph,
       else
         {
           BaseFab<int>       regIrregCovered(ghostRegion, 1);
-          Vector<IrregNode>&  nodes = a_allNodes[dit()];
+          Vector<IrregNode>&  nodes = a_allNodes[di];
 
           if (!a_distributedData)
             {
@@ -378,14 +395,107 @@ EBISLevel::defineGraphFromGeo(LevelData<EBGraph>             & a_graph,
             {
               a_geoserver.fillGraph(regIrregCovered, nodes, region,
                                     ghostRegion, a_domain,
-                                    a_origin, a_dx, dit());
+                                    a_origin, a_dx, di);
             }
           ebgraph.buildGraph(regIrregCovered, nodes, region, a_domain);
 
         }
+      if (a_boxCost != NULL)
+        {
+          (*a_boxCost)[di] = ch_ticks() - start;
+        }
     }
 }
 
+void EBISLevel::rebalance(const LayoutData<unsigned long long>& a_boxCost)
+{
+#ifdef CH_MPI
+  if ((s_rebalanceRatio <= 0) || (numProc() == 1))
+    {
+      return;
+    }
+  CH_TIME("EBISLevel::rebalance");
+
+  //every rank needs the cost of every box
+  Vector<Box> boxes(m_grids.size());
+  Vector<int> procs(m_grids.size());
+  for (LayoutIterator lit = m_grids.layoutIterator(); lit.ok(); ++lit)
+    {
+      boxes[lit().intCode()] = m_grids[lit()];
+      procs[lit().intCode()] = m_grids.procID(lit());
+    }
+
+  //regular and covered boxes still cost something downstream
+  Vector<unsigned long long> localCost(boxes.size(), 0);
+  for (DataIterator dit = m_grids.dataIterator(); dit.ok(); ++dit)
+    {
+      localCost[dit().intCode()] = a_boxCost[dit()] + 1;
+    }
+  Vector<unsigned long long> cost(boxes.size(), 0);
+  MPI_Allreduce(&(localCost[0]), &(cost[0]), boxes.size(),
+                MPI_UNSIGNED_LONG_LONG, MPI_SUM, Chombo_MPI::comm);
+
+  Vector<int> newProcs;
+  UnLongLongLoadBalance(newProcs, cost, boxes);
+
+  Vector<unsigned long long> oldLoad(numProc(), 0);
+  Vector<unsigned long long> newLoad(numProc(), 0);
+  unsigned long long total = 0;
+  for (int ibox = 0; ibox < boxes.size(); ibox++)
+    {
+      oldLoad[procs[ibox]]    += cost[ibox];
+      newLoad[newProcs[ibox]] += cost[ibox];
+      total += cost[ibox];
+    }
+  unsigned long long oldMax = 0;
+  unsigned long long newMax = 0;
+  for (int iproc = 0; iproc < numProc(); iproc++)
+    {
+      oldMax = Max(oldMax, oldLoad[iproc]);
+      newMax = Max(newMax, newLoad[iproc]);
+    }
+  Real average = Real(total)/numProc();
+
+  if ((oldMax <= s_rebalanceRatio*average) || (newMax >= oldMax))
+    {
+      return;
+    }
+  if (s_verbose)
+    {
+      pout() << "EBISLevel::rebalance: busiest rank went from "
+             << oldMax/average << " to " << newMax/average
+             << " times the average" << endl;
+    }
+
+  //move the graph and the data to the new layout
+  DisjointBoxLayout newGrids(boxes, newProcs, m_domain);
+  EBGraphFactory graphfact(m_domain);
+  EBDataFactory  datafact;
+  Interval interv(0,0);
+
+  LevelData<EBGraph> newGraph(newGrids, 1, m_graph.ghostVect(), graphfact);
+  m_graph.copyTo(interv, newGraph, interv);
+
+  LevelData<EBData> newData(newGrids, 1, IntVect::Zero, datafact);
+  for (DataIterator dit = newGrids.dataIterator(); dit.ok(); ++dit)
+    {
+      newData[dit()].defineVoFData( newGraph[dit()], newGrids.get(dit()));
+      newData[dit()].defineFaceData(newGraph[dit()], newGrids.get(dit()));
+    }
+  m_data.copyTo(interv, newData, interv);
+
+  //graphs and data are reference counted so this shares rather than copies
+  m_grids = newGrids;
+  m_graph.define(m_grids, 1, newGraph.ghostVect(), graphfact);
+  m_data.define( m_grids, 1, IntVect::Zero, datafact);
+  for (DataIterator dit = m_grids.dataIterator(); dit.ok(); ++dit)
+    {
+      m_graph[dit()] = newGraph[dit()];
+      m_data[dit()]  = newData[dit()];
+    }
+#endif
+}
+
 EBISLevel::EBISLevel(const ProblemDomain   & a_domain,
                      const RealVect        & a_origin,
                      const Real            & a_dx,
@@ -455,9 +565,10 @@ EBISLevel::EBISLevel(const ProblemDomain   & a_domain,
   EBGraphFactory graphfact(a_domain);
   m_graph.define(m_grids, 1, IntVect::Unit, graphfact);
 
+  LayoutData<unsigned long long> boxCost(m_grids);
   defineGraphFromGeo(m_graph, allNodes, a_geoserver, m_grids,
                      m_domain,m_origin, m_dx, 
-                     a_distributedData);
+                     a_distributedData, &boxCost);
 
   EBDataFactory dataFact;
   m_data.define(m_grids, 1, IntVect::Zero, dataFact);
@@ -467,6 +578,12 @@ EBISLevel::EBISLevel(const ProblemDomain   & a_domain,
 
     }
 
+  //a distributed geometry service keeps its data on the layout it made
+  if (!a_distributedData)
+    {
+      rebalance(boxCost);
+    }
+
   if(a_geoserver.canGenerateMultiCells())
     {
       if (a_fixRegularNextToMultiValued)
@@ -964,6 +1081,9 @@ void EBISLevel::fillEBISLayout(EBISLayout&              a_ebisLayout,
       CH_TIME("ebisllevel::fillebislayout cache miss");
       //int thisghost = Max(s_ebislGhost, a_nghost);
       int thisghost = a_nghost;
+      // start from a fresh implementation, so that layouts already handed
+      // out for a smaller ghost count are left as they are
+      l = EBISLayout();
       l.define(m_domain, a_grids, thisghost, m_graph, m_data);
       m_cacheMisses++;
       m_cacheStale++;
@@ -974,7 +1094,10 @@ void EBISLevel::fillEBISLayout(EBISLayout&              a_ebisLayout,
       CH_TIME("cache_hit");
       m_cacheHits++;
     }
-  a_ebisLayout = l;// refcount is at least 2 now.
+  // a layout with more ghost cells serves a smaller request as is.  the
+  // view reports the ghost count asked for, so layouts made from it
+  // (coarsened EBLevelGrids, say) do not grow their ghost region.
+  a_ebisLayout.define(l, a_nghost);// refcount is at least 2 now.
   if (m_cacheStale == 1)
     {
       refreshCache();
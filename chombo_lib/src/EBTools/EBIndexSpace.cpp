@@ -8,6 +8,8 @@
  */
 #endif
 
+#include <map>
+
 #include "parstream.H"
 #include "memtrack.H"
 #include "memusage.H"
@@ -746,6 +748,21 @@ void EBIndexSpace::fillEBISLayout(EBISLayout&              a_ebisLayout,
   a_ebisLayout.setEBIS(this); //need for mf
 }
 
+// Root of "a_label" in the union-find forest "a_parent" (with path halving)
+static int findLabelRoot(std::map<int,int>& a_parent,
+                         int                a_label)
+{
+  int label = a_label;
+
+  while (a_parent[label] != label)
+  {
+    a_parent[label] = a_parent[a_parent[label]];
+    label = a_parent[label];
+  }
+
+  return label;
+}
+
 // Divide the EBIndexSpace into connected components and return a Vector of
 // disjoint EBIndexSpace's corresponding to each connected component.
 Vector<RefCountedPtr<EBIndexSpace> > EBIndexSpace::findConnectedComponents(int        & a_numComponents,
@@ -764,6 +781,9 @@ Vector<RefCountedPtr<EBIndexSpace> > EBIndexSpace::findConnectedComponents(int
   // All our temporary data structures have one component
   int nComps = 1;
 
+  // There is only one component in each temporary data holder
+  int comp = 0;
+
   // All our temporary data structures have one layer of ghostcells
   int nGhosts = 1;
   IntVect ghostCells = nGhosts * IntVect::Unit;
@@ -793,8 +813,11 @@ Vector<RefCountedPtr<EBIndexSpace> > EBIndexSpace::findConnectedComponents(int
   }
 
   // Get the coarsest level and number the connected components at that level.
-  // The current implementation assumes there is only one box at the coarsest
-  // level - this is checked below.
+  // The coarsest level may have any number of boxes spread over any number
+  // of processors.  Each box is labeled independently, the labels that touch
+  // across box boundaries are merged (union-find over equivalence pairs
+  // found through the ghost cells), and, finally, the merged components are
+  // renumbered 0 to numEBIS-1.
   EBISLevel* coarEBISLevel = m_ebisLevel[m_nlevels-1];
 
   DisjointBoxLayout coarGrids = coarEBISLevel->m_grids;
@@ -808,30 +831,15 @@ Vector<RefCountedPtr<EBIndexSpace> > EBIndexSpace::findConnectedComponents(int
   // Initialize all the component numbers to -1 (invalid)
   EBLevelDataOps::setVal(coarNumberedComponents,-1.0);
 
-  // Currently this code will only work if there is only on box at the
-  // coarsest level of the geometry.  This will need to be fixed by merging
-  // different numberings of the same component in different boxes.  This can
-  // be done via ghost cells, exchanges, the building of equivalence classes,
-  // and, finally, a renumbering operation.
-  unsigned int numGrids = coarGrids.size();
-
-  if (numGrids > 1)
-  {
-    pout() << "Number of coarsest grids: " << numGrids << endl;
-    pout() << "Grids: " << coarGrids << endl;
-    MayDay::Error("EBIndexSpace::connectedComponents - algorithm currently only works if there is only one box at the coarsest geometry level");
-  }
-
-  // For counting the new EBIndexspace's and remember the number assigned to
-  // each
-  int numEBIS = 0;
-  Vector<int> valueEBIS;
+  // Labels are made unique over all boxes by starting each box at its box
+  // index and striding by the number of boxes.
+  int numGrids = coarGrids.size();
 
-  // Used if "a_onlyBiggest" is true to get the biggest connected component
-  Real maxVolFrac = 0.0;
-  int biggestEBIS = -1;
+  // Box local labels and the volume fraction of each
+  Vector<int>  localLabels;
+  Vector<Real> localVolFracs;
 
-  // Go through all (one) boxes (see comments and MayDay above).
+  // Go through all the local boxes and label everything within each box
   for (DataIterator dit = coarGrids.dataIterator(); dit.ok(); ++dit)
   {
     CH_TIME("EBIndexSpace::connectedComponents-loop2");
@@ -846,7 +854,7 @@ Vector<RefCountedPtr<EBIndexSpace> > EBIndexSpace::findConnectedComponents(int
     const EBGraph& curEBGraph   = coarEBISLevel->m_graph[dit()];
     const EBISBox& curEBISBox   = curEBCellFAB.getEBISBox();
 
-    unsigned int curNum = boxIndex;
+    int curNum = boxIndex;
 
     // Iterate through the box, VoF by VoF and number anything that isn't
     // already numbered.
@@ -857,84 +865,261 @@ Vector<RefCountedPtr<EBIndexSpace> > EBIndexSpace::findConnectedComponents(int
 
       Real totalVolFrac;
 
-      // Examine the connected component starting at "vof".  If it hasn't been
-      // numbered yet, return true otherwise false.  Also, return the
-      // volume fraction associated with the connect component.
-      if (setAllConnectedVoFs(totalVolFrac,curEBCellFAB,curEBGraph,curEBISBox,vof,vof,curNum))
+      // Label the part of the connected component starting at "vof" that
+      // lies in this box.  If it hasn't been numbered yet, return true
+      // otherwise false.  Also, return the volume fraction of that part.
+      if (setAllConnectedVoFs(totalVolFrac,curEBCellFAB,curEBISBox,curBox,vof,curNum))
       {
-        if (totalVolFrac > 0.0)
+        localLabels  .push_back(curNum);
+        localVolFracs.push_back(totalVolFrac);
+
+        // Check to see that the numbering can be incremented and then
+        // increment it.
+        if (curNum + numGrids < curNum)
         {
-          // If a connected component was numbered, check to see for the
-          // numbering can be incremented and then increment it.
-          if (curNum + numGrids < curNum)
+          MayDay::Error("EBIndexSpace::connectedComponents - Component index overflow");
+        }
+
+        curNum += numGrids;
+      }
+    }
+  }
+
+  // Fill the ghost cells with the labels of the neighboring boxes
+  coarNumberedComponents.exchange();
+
+  // Labels that belong to the same component because a face connects
+  // them across a box boundary are merged here first (union-find over the
+  // labels this processor sees), so only the result, not every face, is
+  // sent on.
+  std::map<int,int> localParent;
+
+  for (DataIterator dit = coarGrids.dataIterator(); dit.ok(); ++dit)
+  {
+    CH_TIME("EBIndexSpace::connectedComponents-equivalences");
+
+    const Box& curBox = coarGrids.get(dit());
+
+    // Only cells on the boundary of the box have faces leaving it
+    IntVectSet boundaryIVS(curBox);
+    Box interior = curBox;
+    interior.grow(-1);
+    if (!interior.isEmpty())
+    {
+      boundaryIVS -= interior;
+    }
+
+    const EBCellFAB& curEBCellFAB = coarNumberedComponents[dit()];
+    const EBGraph&   curEBGraph   = coarEBISLevel->m_graph[dit()];
+    const EBISBox&   curEBISBox   = curEBCellFAB.getEBISBox();
+
+    for (VoFIterator vofit(boundaryIVS,curEBGraph); vofit.ok(); ++vofit)
+    {
+      const VolIndex& vof = vofit();
+
+      int curLabel = (int)curEBCellFAB(vof,comp);
+
+      for (int idir = 0; idir < SpaceDim; idir++)
+      {
+        for (SideIterator sit; sit.ok(); ++sit)
+        {
+          const Side::LoHiSide& curSide = sit();
+
+          if (curBox.contains(vof.gridIndex() + sign(curSide)*BASISV(idir)))
           {
-            MayDay::Error("EBIndexSpace::connectedComponents - Component index overflow");
+            continue;
           }
 
-          // Remember the component number and increment the number of
-          // components
-          valueEBIS.push_back(curNum);
-          numEBIS++;
+          const Vector<FaceIndex> faces = curEBISBox.getFaces(vof,idir,curSide);
 
-          // Find the biggest connected component
-          if (totalVolFrac > maxVolFrac)
+          for (int iface = 0; iface < faces.size(); iface++)
           {
-            maxVolFrac = totalVolFrac;
-            biggestEBIS = curNum;
+            const VolIndex& nextVoF = faces[iface].getVoF(curSide);
+
+            if (nextVoF.cellIndex() >= 0)
+            {
+              int nextLabel = (int)curEBCellFAB(nextVoF,comp);
+
+              if (nextLabel >= 0 && nextLabel != curLabel)
+              {
+                if (localParent.find(curLabel) == localParent.end())
+                {
+                  localParent[curLabel] = curLabel;
+                }
+                if (localParent.find(nextLabel) == localParent.end())
+                {
+                  localParent[nextLabel] = nextLabel;
+                }
+
+                int root0 = findLabelRoot(localParent,curLabel);
+                int root1 = findLabelRoot(localParent,nextLabel);
+
+                if (root0 < root1)
+                {
+                  localParent[root1] = root0;
+                }
+                else if (root1 < root0)
+                {
+                  localParent[root0] = root1;
+                }
+              }
+            }
           }
+        }
+      }
+    }
+  }
+
+  // One (label, root) pair for each label that isn't its own local root
+  Vector<int> localPairs;
+
+  for (std::map<int,int>::iterator it = localParent.begin(); it != localParent.end(); ++it)
+  {
+    int root = findLabelRoot(localParent,it->first);
+
+    if (root != it->first)
+    {
+      localPairs.push_back(it->first);
+      localPairs.push_back(root);
+    }
+  }
+
+  // Merge the labels on one processor and send everyone the result which is
+  // stored as: numEBIS, biggestEBIS, then (old label, new label) pairs.
+  int srcProc = uniqueProc(SerialTask::compute);
+
+  Vector<Vector<int> >  allLabels;
+  Vector<Vector<Real> > allVolFracs;
+  Vector<Vector<int> >  allPairs;
+
+  gather(allLabels,  localLabels,  srcProc);
+  gather(allVolFracs,localVolFracs,srcProc);
+  gather(allPairs,   localPairs,   srcProc);
+
+  Vector<int> renumbering;
+
+  if (procID() == srcProc)
+  {
+    CH_TIME("EBIndexSpace::connectedComponents-merge");
+
+    // Union-find over the labels.  The root of each set is its smallest
+    // label so the final numbering doesn't depend on the processor layout.
+    std::map<int,int> parent;
+
+    for (int iproc = 0; iproc < allLabels.size(); iproc++)
+    {
+      for (int i = 0; i < allLabels[iproc].size(); i++)
+      {
+        parent[allLabels[iproc][i]] = allLabels[iproc][i];
+      }
+    }
+
+    for (int iproc = 0; iproc < allPairs.size(); iproc++)
+    {
+      const Vector<int>& pairs = allPairs[iproc];
+
+      for (int i = 0; i < pairs.size(); i += 2)
+      {
+        int root0 = findLabelRoot(parent,pairs[i]);
+        int root1 = findLabelRoot(parent,pairs[i+1]);
 
-          // New number of the next component (if there is one)
-          curNum += numGrids;
+        if (root0 < root1)
+        {
+          parent[root1] = root0;
         }
-        else
+        else if (root1 < root0)
         {
-          // If we're not counting the current component (because it has a total
-          // volume fraction of 0.0, set the component number back to -1
+          parent[root0] = root1;
+        }
+      }
+    }
+
+    // Total volume fraction of each merged component
+    std::map<int,Real> rootVolFrac;
+
+    for (int iproc = 0; iproc < allLabels.size(); iproc++)
+    {
+      for (int i = 0; i < allLabels[iproc].size(); i++)
+      {
+        rootVolFrac[findLabelRoot(parent,allLabels[iproc][i])] += allVolFracs[iproc][i];
+      }
+    }
+
+    // Number the components with a nonzero volume fraction in order of
+    // their smallest label.  Components with a total volume fraction of 0.0
+    // aren't counted and their VoFs are set back to -1.
+    int numEBIS = 0;
+    Real maxVolFrac = 0.0;
+    int biggestEBIS = -1;
+
+    std::map<int,int> rootNumber;
 
-          resetAllConnectedVoFs(curEBCellFAB,curEBGraph,curEBISBox,vof,vof);
+    for (std::map<int,Real>::const_iterator it = rootVolFrac.begin(); it != rootVolFrac.end(); ++it)
+    {
+      if (it->second > 0.0)
+      {
+        if (it->second > maxVolFrac)
+        {
+          maxVolFrac  = it->second;
+          biggestEBIS = numEBIS;
         }
+
+        rootNumber[it->first] = numEBIS;
+        numEBIS++;
+      }
+      else
+      {
+        rootNumber[it->first] = -1;
       }
     }
+
+    renumbering.push_back(numEBIS);
+    renumbering.push_back(biggestEBIS);
+
+    for (std::map<int,int>::iterator it = parent.begin(); it != parent.end(); ++it)
+    {
+      renumbering.push_back(it->first);
+      renumbering.push_back(rootNumber[findLabelRoot(parent,it->first)]);
+    }
   }
 
-#ifdef CH_MPI
-  // Sum up the numEBIS on all processors
-  int sumNumEBIS;
+  broadcast(renumbering,srcProc);
 
-  int result = MPI_Allreduce(&numEBIS, &sumNumEBIS, 1, MPI_INT, MPI_SUM, Chombo_MPI::comm);
+  int numEBIS     = renumbering[0];
+  int biggestEBIS = renumbering[1];
 
-  if (result != MPI_SUCCESS)
+  // Renumber the local VoFs
   {
-    MayDay::Error("Communication error summing 'numEBIS'");
-  }
+    CH_TIME("EBIndexSpace::connectedComponents-renumber");
 
-  numEBIS = sumNumEBIS;
+    std::map<int,int> newNumber;
+    for (int i = 2; i < renumbering.size(); i += 2)
+    {
+      newNumber[renumbering[i]] = renumbering[i+1];
+    }
 
-  typedef struct
-  {
-    double maxVolFrac;
-    int    biggestEBIS;
-  } CH_MPI_MAXLOC;
+    for (DataIterator dit = coarGrids.dataIterator(); dit.ok(); ++dit)
+    {
+      const Box& curBox = coarGrids.get(dit());
+      const IntVectSet curIVS(curBox);
 
-  CH_MPI_MAXLOC localMax;
-  CH_MPI_MAXLOC globalMax;
+      EBCellFAB&     curEBCellFAB = coarNumberedComponents[dit()];
+      const EBGraph& curEBGraph   = coarEBISLevel->m_graph[dit()];
 
-  // Get the connected component index of the largest connected component on
-  // all processors
-  localMax.maxVolFrac  = maxVolFrac;
-  localMax.biggestEBIS = biggestEBIS;
+      for (VoFIterator vofit(curIVS,curEBGraph); vofit.ok(); ++vofit)
+      {
+        const VolIndex& vof = vofit();
 
-  result = MPI_Allreduce(&localMax, &globalMax, 1, MPI_DOUBLE_INT, MPI_MAXLOC, Chombo_MPI::comm);
+        int oldLabel = (int)curEBCellFAB(vof,comp);
 
-  if (result != MPI_SUCCESS)
-  {
-    MayDay::Error("Communication error maximizing 'maxVolFrac'");
+        if (oldLabel >= 0)
+        {
+          curEBCellFAB(vof,comp) = newNumber[oldLabel];
+        }
+      }
+    }
   }
 
-  maxVolFrac  = globalMax.maxVolFrac;
-  biggestEBIS = globalMax.biggestEBIS;
-#endif
-
   a_numComponents = numEBIS;
 
   int minEBIS;
@@ -966,12 +1151,6 @@ Vector<RefCountedPtr<EBIndexSpace> > EBIndexSpace::findConnectedComponents(int
   // Make sure all ghostcells are correct
   coarNumberedComponents.exchange();
 
-  // At this point, renumber the connected components from 0 to numEBIS-1.
-  // Currently, this is already the case so nothing happens here.
-
-  // There is only one component in each temporary data holder
-  int comp = 0;
-
   // The refinement ratio on the geometry size of things is always 2
   int nRef = 2;
 
@@ -1822,31 +2001,38 @@ RefCountedPtr<EBIndexSpace> EBIndexSpace::biggestConnectedComponent(int & a_numC
   return biggest[0];
 }
 
-// Recursively find all VoFs connected to "a_curVoF" and number them
-// "a_curNum".  This works on a single EBCellFAB.  "a_lastVoF" is used to
-// avoid recursing back to the VoF that generated that call to this routine.
-// For the first call, "a_lastVoF" should equal "a_curVoF" since this allows
-// recursion using all faces.
-bool EBIndexSpace::setAllConnectedVoFs(Real&               a_totalVolFrac,
-                                       EBCellFAB&          a_curEBCellFAB,
-                                       const EBGraph&      a_curEBGraph,
-                                       const EBISBox&      a_curEBISBox,
-                                       const VolIndex&     a_curVoF,
-                                       const VolIndex&     a_lastVoF,
-                                       const unsigned int& a_curNum)
+// Find all VoFs in "a_curBox" connected to "a_startVoF" and number them
+// "a_curNum".  This works on a single EBCellFAB and doesn't follow faces out
+// of "a_curBox" - connections between boxes are found separately.  An
+// explicit stack is used instead of recursion since a connected component
+// can cover the whole box.
+bool EBIndexSpace::setAllConnectedVoFs(Real&           a_totalVolFrac,
+                                       EBCellFAB&      a_curEBCellFAB,
+                                       const EBISBox&  a_curEBISBox,
+                                       const Box&      a_curBox,
+                                       const VolIndex& a_startVoF,
+                                       const int&      a_curNum)
 {
-  bool foundNewVoF = false;
-
   a_totalVolFrac = 0.0;
 
   int comp = 0;
 
-  if (a_curEBCellFAB(a_curVoF,comp) == -1.0)
+  if (a_curEBCellFAB(a_startVoF,comp) != -1.0)
   {
-    foundNewVoF = true;
+    return false;
+  }
+
+  Vector<VolIndex> stack;
 
-    a_curEBCellFAB(a_curVoF,comp) = a_curNum;
-    a_totalVolFrac += a_curEBISBox.volFrac(a_curVoF);
+  a_curEBCellFAB(a_startVoF,comp) = a_curNum;
+  stack.push_back(a_startVoF);
+
+  while (stack.size() > 0)
+  {
+    const VolIndex curVoF = stack.back();
+    stack.pop_back();
+
+    a_totalVolFrac += a_curEBISBox.volFrac(curVoF);
 
     for (int idir = 0; idir < SpaceDim; idir++)
     {
@@ -1854,75 +2040,25 @@ bool EBIndexSpace::setAllConnectedVoFs(Real&               a_totalVolFrac,
       {
         const Side::LoHiSide& curSide = sit();
 
-        const Vector<FaceIndex> faces = a_curEBISBox.getFaces(a_curVoF,idir,curSide);
+        const Vector<FaceIndex> faces = a_curEBISBox.getFaces(curVoF,idir,curSide);
 
         for (int iface = 0; iface < faces.size(); iface++)
         {
-          const FaceIndex& face = faces[iface];
-
-          const VolIndex& nextVoF = face.getVoF(curSide);
+          const VolIndex& nextVoF = faces[iface].getVoF(curSide);
 
-
-          if (nextVoF.cellIndex() >= 0 && nextVoF != a_lastVoF)
+          if (nextVoF.cellIndex() >= 0 &&
+              a_curBox.contains(nextVoF.gridIndex()) &&
+              a_curEBCellFAB(nextVoF,comp) == -1.0)
           {
-            Real totalVolFrac;
-
-            setAllConnectedVoFs(totalVolFrac,
-                                a_curEBCellFAB,
-                                a_curEBGraph,
-                                a_curEBISBox,
-                                nextVoF,
-                                a_curVoF,
-                                a_curNum);
-
-            a_totalVolFrac += totalVolFrac;
+            a_curEBCellFAB(nextVoF,comp) = a_curNum;
+            stack.push_back(nextVoF);
           }
         }
       }
     }
   }
 
-  return foundNewVoF;
-}
-
-// Undo everything done by "setAllConnectedVoFs" - this is needed if the total
-// volume fraction found by "setAllConnectedVoFs" is 0.0 because then this
-// connected component will be ignored.
-void EBIndexSpace::resetAllConnectedVoFs(EBCellFAB&          a_curEBCellFAB,
-                                         const EBGraph&      a_curEBGraph,
-                                         const EBISBox&      a_curEBISBox,
-                                         const VolIndex&     a_curVoF,
-                                         const VolIndex&     a_lastVoF)
-{
-  int comp = 0;
-
-  a_curEBCellFAB(a_curVoF,comp) = -1.0;
-
-  for (int idir = 0; idir < SpaceDim; idir++)
-  {
-    for (SideIterator sit; sit.ok(); ++sit)
-    {
-      const Side::LoHiSide& curSide = sit();
-
-      const Vector<FaceIndex> faces = a_curEBISBox.getFaces(a_curVoF,idir,curSide);
-
-      for (int iface = 0; iface < faces.size(); iface++)
-      {
-        const FaceIndex& face = faces[iface];
-
-        const VolIndex& nextVoF = face.getVoF(curSide);
-
-        if (nextVoF.cellIndex() >= 0 && nextVoF != a_lastVoF)
-        {
-          resetAllConnectedVoFs(a_curEBCellFAB,
-                                a_curEBGraph,
-                                a_curEBISBox,
-                                nextVoF,
-                                a_curVoF);
-        }
-      }
-    }
-  }
+  return true;
 }
 
 #include "NamespaceFooter.H"
@@ -1467,22 +1467,29 @@ void EBLevelDataOps::gatherBroadCast(Real& a_accum, Real& a_volume, const int& a
 //   gatherBroadCast(accum, a_volume, a_p);
 //   a_accum = accum[0];
 #ifdef CH_MPI
+  gatherBroadCast(a_accum, a_volume, a_p, Chombo_MPI::comm);
+#endif
+
+}
+
+#ifdef CH_MPI
+void EBLevelDataOps::gatherBroadCast(Real& a_accum, Real& a_volume, const int& a_p, MPI_Comm a_comm)
+{
   Real tmp=a_volume;
-  MPI_Allreduce(&tmp, &a_volume, 1, MPI_CH_REAL, MPI_SUM, Chombo_MPI::comm);
+  MPI_Allreduce(&tmp, &a_volume, 1, MPI_CH_REAL, MPI_SUM, a_comm);
   tmp = a_accum;
   if (a_p==0)
     {
       MPI_Allreduce(&tmp, &a_accum, 1, MPI_CH_REAL,
-                    MPI_MAX, Chombo_MPI::comm);
+                    MPI_MAX, a_comm);
     }
   else
     {
       MPI_Allreduce(&tmp, &a_accum, 1, MPI_CH_REAL,
-                    MPI_SUM, Chombo_MPI::comm);
+                    MPI_SUM, a_comm);
     }
-#endif
-
 }
+#endif
 
 void EBLevelDataOps::gatherBroadCast(Vector<Real>& a_accum, Real& a_volume, const int& a_p)
 {
@@ -1699,6 +1706,46 @@ Real EBLevelDataOps::kappaDotProduct(Real&                       a_volume,
                                      const ProblemDomain&        a_domain)
 {
   CH_TIME("EBLevelDataOps::kappaDotProduct");
+  Real accum = localKappaDotProduct(a_volume, a_data1, a_data2, a_which, a_domain);
+
+  gatherBroadCast(accum, a_volume, 1);
+
+  if (a_volume > 0.0)
+    {
+      accum = accum / a_volume;
+    }
+
+  return accum;
+}
+
+#ifdef CH_MPI
+Real EBLevelDataOps::kappaDotProduct(Real&                       a_volume,
+                                     const LevelData<EBCellFAB>& a_data1,
+                                     const LevelData<EBCellFAB>& a_data2,
+                                     int                         a_which,
+                                     const ProblemDomain&        a_domain,
+                                     MPI_Comm                    a_comm)
+{
+  CH_TIME("EBLevelDataOps::kappaDotProduct");
+  Real accum = localKappaDotProduct(a_volume, a_data1, a_data2, a_which, a_domain);
+
+  gatherBroadCast(accum, a_volume, 1, a_comm);
+
+  if (a_volume > 0.0)
+    {
+      accum = accum / a_volume;
+    }
+
+  return accum;
+}
+#endif
+
+Real EBLevelDataOps::localKappaDotProduct(Real&                       a_volume,
+                                          const LevelData<EBCellFAB>& a_data1,
+                                          const LevelData<EBCellFAB>& a_data2,
+                                          int                         a_which,
+                                          const ProblemDomain&        a_domain)
+{
   Real accum = 0.0;
 
   a_volume = 0.0;
@@ -1718,13 +1765,6 @@ Real EBLevelDataOps::kappaDotProduct(Real&                       a_volume,
       accum += cur;
     }
 
-  gatherBroadCast(accum, a_volume, 1);
-
-  if (a_volume > 0.0)
-    {
-      accum = accum / a_volume;
-    }
-
   return accum;
 }
 
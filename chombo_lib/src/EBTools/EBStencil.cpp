@@ -218,7 +218,8 @@ void EBStencil::apply(EBCellFAB&             a_lofphi,
                       const BaseIVFAB<Real>& a_alphaWeight,
                       Real                   a_alpha,
                       Real                   a_beta,
-                      bool                   a_incrementOnly) const
+                      bool                   a_incrementOnly,
+                      int                    a_ivar) const
 
 {
   if (!m_doRelaxOpt)
@@ -233,11 +234,11 @@ void EBStencil::apply(EBCellFAB&             a_lofphi,
   CH_assert(a_lofphi.getSingleValuedFAB().box() == m_lphBox);
   CH_assert(a_phi.getSingleValuedFAB().box()    == m_phiBox);
 
-  const Real* singleValuedPtrPhi =    a_phi.getSingleValuedFAB().dataPtr(0);
-  Real*       singleValuedPtrLph = a_lofphi.getSingleValuedFAB().dataPtr(0);
+  const Real* singleValuedPtrPhi =    a_phi.getSingleValuedFAB().dataPtr(a_ivar);
+  Real*       singleValuedPtrLph = a_lofphi.getSingleValuedFAB().dataPtr(a_ivar);
 
-  const Real* multiValuedPtrPhi =    a_phi.getMultiValuedFAB().dataPtr(0);
-  Real*       multiValuedPtrLph = a_lofphi.getMultiValuedFAB().dataPtr(0);
+  const Real* multiValuedPtrPhi =    a_phi.getMultiValuedFAB().dataPtr(a_ivar);
+  Real*       multiValuedPtrLph = a_lofphi.getMultiValuedFAB().dataPtr(a_ivar);
 
   const Real* alphaWeightPtr = a_alphaWeight.dataPtr(0);
 
@@ -301,7 +302,8 @@ void EBStencil::apply(EBCellFAB&             a_lofphi,
                       const Real             a_beta,
                       const BaseIVFAB<Real>& a_betaWeight,
                       Real                   a_one,
-                      bool                   a_incrementOnly) const
+                      bool                   a_incrementOnly,
+                      int                    a_ivar) const
 
 {
   if (!m_doRelaxOpt)
@@ -316,11 +318,11 @@ void EBStencil::apply(EBCellFAB&             a_lofphi,
   CH_assert(a_lofphi.getSingleValuedFAB().box() == m_lphBox);
   CH_assert(a_phi.getSingleValuedFAB().box()    == m_phiBox);
 
-  const Real* singleValuedPtrPhi =    a_phi.getSingleValuedFAB().dataPtr(0);
-  Real*       singleValuedPtrLph = a_lofphi.getSingleValuedFAB().dataPtr(0);
+  const Real* singleValuedPtrPhi =    a_phi.getSingleValuedFAB().dataPtr(a_ivar);
+  Real*       singleValuedPtrLph = a_lofphi.getSingleValuedFAB().dataPtr(a_ivar);
 
-  const Real* multiValuedPtrPhi =    a_phi.getMultiValuedFAB().dataPtr(0);
-  Real*       multiValuedPtrLph = a_lofphi.getMultiValuedFAB().dataPtr(0);
+  const Real* multiValuedPtrPhi =    a_phi.getMultiValuedFAB().dataPtr(a_ivar);
+  Real*       multiValuedPtrLph = a_lofphi.getMultiValuedFAB().dataPtr(a_ivar);
 
   const Real* alphaWeightPtr = a_alphaWeight.dataPtr(0);
   const Real* betaWeightPtr = a_betaWeight.dataPtr(0);
@@ -430,7 +432,8 @@ void EBStencil::relax(EBCellFAB&             a_phi,
                       const BaseIVFAB<Real>& a_betaWeight,
                       Real                   a_alpha,
                       Real                   a_beta,
-                      Real                   a_safety) const
+                      Real                   a_safety,
+                      int                    a_ivar) const
 {
   if (!m_doRelaxOpt)
     {
@@ -445,11 +448,11 @@ void EBStencil::relax(EBCellFAB&             a_phi,
   CH_assert(a_rhs.getSingleValuedFAB().box() == m_lphBox);
   CH_assert(a_phi.getSingleValuedFAB().box() == m_phiBox);
 
-  Real*       singleValuedPtrPhi =    a_phi.getSingleValuedFAB().dataPtr(0);
-  const Real* singleValuedPtrLph =    a_rhs.getSingleValuedFAB().dataPtr(0);
+  Real*       singleValuedPtrPhi =    a_phi.getSingleValuedFAB().dataPtr(a_ivar);
+  const Real* singleValuedPtrLph =    a_rhs.getSingleValuedFAB().dataPtr(a_ivar);
 
-  Real*       multiValuedPtrPhi =    a_phi.getMultiValuedFAB().dataPtr(0);
-  const Real* multiValuedPtrLph =    a_rhs.getMultiValuedFAB().dataPtr(0);
+  Real*       multiValuedPtrPhi =    a_phi.getMultiValuedFAB().dataPtr(a_ivar);
+  const Real* multiValuedPtrLph =    a_rhs.getMultiValuedFAB().dataPtr(a_ivar);
 
   const Real* alphaWeightPtr = a_alphaWeight.dataPtr(0);
   const Real*  betaWeightPtr =  a_betaWeight.dataPtr(0);
@@ -33,6 +33,15 @@ bool GeometryService::canGenerateMultiCells() const
   return true;
 }
 
+bool GeometryService::isThreadSafe() const
+{
+  return false;
+}
+
+void GeometryService::prepareFillGraph(const Real& a_dx) const
+{
+}
+
 GeometryService::InOut GeometryService::InsideOutside(const Box&           a_region,
                                                       const ProblemDomain& a_domain,
                                                       const RealVect&      a_origin,
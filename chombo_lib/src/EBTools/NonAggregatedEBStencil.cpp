@@ -13,6 +13,18 @@
 #include "EBFaceFAB.H"
 #include "NamespaceHeader.H"
 /**************/
+//applies a scalar vof stencil to component a_ivar of a_fab
+static Real applyVoFStencilToComp(const VoFStencil& a_sten, const EBCellFAB& a_fab, const int& a_ivar)
+{
+  Real retval = 0.;
+  for (int isten = 0; isten < a_sten.size(); isten++)
+    {
+      retval += (a_sten.weight(isten))*(a_fab((a_sten.vof(isten)), a_sten.variable(isten) + a_ivar));
+    }
+
+  return retval;
+}
+/**************/
 /**************/
 /**************/
 NonAggregatedEBStencil::NonAggregatedEBStencil(const Vector<VolIndex>& a_srcVofs,
@@ -95,21 +107,22 @@ void NonAggregatedEBStencil::apply(EBCellFAB&             a_lofphi,
                                    const BaseIVFAB<Real>& a_alphaWeight,
                                    Real                   a_alpha,
                                    Real                   a_beta,
-                                   bool                   a_incrementOnly) const
+                                   bool                   a_incrementOnly,
+                                   int                    a_ivar) const
 
 {
   CH_TIME("NonAggregatedEBStencil::apply1");
   for (int isrc = 0; isrc < m_srcVofs.size(); isrc++)
     {
       const VolIndex& vof = m_srcVofs[isrc];
-      Real& lphi = a_lofphi(vof, m_destVar);
+      Real& lphi = a_lofphi(vof, m_destVar + a_ivar);
 
       if (!a_incrementOnly)
         {
           lphi =  0.;
         }
-      Real stenval   = applyVoFStencil(m_vofStencil[isrc], a_phi, 0);
-      Real totalval  = a_alpha*a_alphaWeight(vof, 0)*a_phi(vof,0) + a_beta*stenval;
+      Real stenval   = applyVoFStencilToComp(m_vofStencil[isrc], a_phi, a_ivar);
+      Real totalval  = a_alpha*a_alphaWeight(vof, 0)*a_phi(vof, a_ivar) + a_beta*stenval;
       lphi += totalval;
     }
 }
@@ -125,14 +138,15 @@ void NonAggregatedEBStencil::apply(EBCellFAB&             a_lofphi,
                                    const Real             a_beta,
                                    const BaseIVFAB<Real>& a_betaWeight,
                                    Real                   a_one,
-                                   bool                   a_incrementOnly) const
+                                   bool                   a_incrementOnly,
+                                   int                    a_ivar) const
 
 {
   CH_TIME("NonAggregatedEBStencil::apply2");
   for (int isrc = 0; isrc < m_srcVofs.size(); isrc++)
     {
       const VolIndex& vof = m_srcVofs[isrc];
-      Real& lphi = a_lofphi(vof, m_destVar);
+      Real& lphi = a_lofphi(vof, m_destVar + a_ivar);
 
       if (!a_incrementOnly)
         {
@@ -141,7 +155,7 @@ void NonAggregatedEBStencil::apply(EBCellFAB&             a_lofphi,
       //for some reason this version does not include lphi in EBStencil ---dtg
       //Real stenval   = applyVoFStencil(m_vofStencil[isrc], a_phi, 0);
       //      lphi += stenval
-      Real phival    = a_phi(vof, 0);
+      Real phival    = a_phi(vof, a_ivar);
 
       Real alphaWeight = a_alphaWeight(vof, 0);
       Real betaWeight =  a_betaWeight(vof, 0);
@@ -174,15 +188,16 @@ void NonAggregatedEBStencil::relax(EBCellFAB&             a_phi,
                                    const BaseIVFAB<Real>& a_betaWeight,
                                    Real                   a_alpha,
                                    Real                   a_beta,
-                                   Real                   a_safety) const
+                                   Real                   a_safety,
+                                   int                    a_ivar) const
 {
   CH_TIME("NonAggregatedEBStencil::relax");
   for (int isrc = 0; isrc < m_srcVofs.size(); isrc++)
     {
       const VolIndex& vof = m_srcVofs[isrc];
-      Real& phi = a_phi(vof,0);
-      Real rhs = a_rhs(vof, 0);
-      Real stenval   = applyVoFStencil(m_vofStencil[isrc], a_phi, 0);
+      Real& phi = a_phi(vof, a_ivar);
+      Real rhs = a_rhs(vof, a_ivar);
+      Real stenval   = applyVoFStencilToComp(m_vofStencil[isrc], a_phi, a_ivar);
       Real alphaWeight = a_alphaWeight(vof, 0);
       Real betaWeight = a_betaWeight(vof, 0);
       Real denom = a_alpha*alphaWeight + a_beta*betaWeight;
@@ -59,6 +59,22 @@ Real ComplementIF::value(const RealVect& a_point) const
   return retval;
 }
 
+void ComplementIF::value(const RealVect* a_points,
+                         Real*           a_values,
+                         int             a_npts) const
+{
+  m_impFunc->value(a_points, a_values, a_npts);
+
+  // Negate if complement is turned on (true)
+  if (m_complement)
+    {
+      for (int ipt = 0; ipt < a_npts; ipt++)
+        {
+          a_values[ipt] = -a_values[ipt];
+        }
+    }
+}
+
 Real ComplementIF::value(const IndexTM<Real,GLOBALDIM>& a_point) const
 {
 
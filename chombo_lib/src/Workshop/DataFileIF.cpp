@@ -8,12 +8,43 @@
  */
 #endif
 
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
 #include "DataFileIF.H"
 
 #include "NamespaceHeader.H"
 
 using std::cin;
 
+// Binary data aliased to a memory mapped file, which is unmapped when the
+// last DataFileIF sharing it goes away
+class MappedDataFab: public BaseFab<unsigned char>
+{
+public:
+  MappedDataFab(const Box&     a_box,
+                unsigned char* a_data,
+                void*          a_map,
+                size_t         a_mapSize)
+    :BaseFab<unsigned char>(a_box,1,a_data),
+     m_map(a_map),
+     m_mapSize(a_mapSize)
+  {
+  }
+
+  virtual ~MappedDataFab()
+  {
+    munmap(m_map,m_mapSize);
+  }
+
+protected:
+  void*  m_map;
+  size_t m_mapSize;
+};
+
 DataFileIF::DataFileIF(const DataFileIF::DataType& a_dataType,
                        const Real&                 a_value,
                        const bool&                 a_inside,
@@ -48,8 +79,15 @@ DataFileIF::DataFileIF(const char* const           a_filename,
   // Read an entire header from the file - see .H file
   ReadFullHeader(m_num,m_spacing,m_origin,curFile);
 
-  // Read all the data from the file
-  ReadData(m_noDataValue,curFile,a_dataType,m_num);
+  // Read (or map) all the data from the file
+  if (a_dataType == DataFileIF::MappedBinary)
+  {
+    MapData(m_noDataValue,a_filename,curFile.tellg(),m_num);
+  }
+  else
+  {
+    ReadData(m_noDataValue,curFile,a_dataType,m_num);
+  }
 
   // Close the named file
   CloseFile(curFile);
@@ -109,8 +147,15 @@ DataFileIF::DataFileIF(const char* const           a_filename,
   m_spacing = a_spacing;
   m_origin = a_origin;
 
-  // Read all the data from the file
-  ReadData(m_noDataValue,curFile,a_dataType,m_num);
+  // Read (or map) all the data from the file
+  if (a_dataType == DataFileIF::MappedBinary)
+  {
+    MapData(m_noDataValue,a_filename,curFile.tellg(),m_num);
+  }
+  else
+  {
+    ReadData(m_noDataValue,curFile,a_dataType,m_num);
+  }
 
   // Close the named file
   CloseFile(curFile);
@@ -168,8 +213,15 @@ DataFileIF::DataFileIF(const char* const           a_filename,
   m_spacing = a_spacing;
   m_origin = a_origin;
 
-  // Read all the data from the file
-  ReadData(m_noDataValue,curFile,a_dataType,m_num);
+  // Read (or map) all the data from the file
+  if (a_dataType == DataFileIF::MappedBinary)
+  {
+    MapData(m_noDataValue,a_filename,curFile.tellg(),m_num);
+  }
+  else
+  {
+    ReadData(m_noDataValue,curFile,a_dataType,m_num);
+  }
 
   // Close the named file
   CloseFile(curFile);
@@ -353,7 +405,7 @@ Real DataFileIF::value(const IndexTM<int,GLOBALDIM> & a_partialDerivative,
 
   if (!m_useCubicInterp)
   {
-    Vector<Vector<Real> > linear(GLOBALDIM,Vector<Real>(2));
+    Real linear[GLOBALDIM][2];
     bool zeroWeight = false;
 
     for (int idir = 0; idir < GLOBALDIM; idir++)
@@ -428,7 +480,7 @@ Real DataFileIF::value(const IndexTM<int,GLOBALDIM> & a_partialDerivative,
   }
   else
   {
-    Vector<Vector<Real> > cubic(GLOBALDIM,Vector<Real>(4));
+    Real cubic[GLOBALDIM][4];
     bool zeroWeight = false;
 
     for (int idir = 0; idir < GLOBALDIM; idir++)
@@ -767,74 +819,37 @@ void DataFileIF::ReadData(Real&                       a_maxValue,
   }
   else if (a_dataType == DataFileIF::Binary)
   {
-    // Binary data - read the data one entry at a time
+    // Binary data - one byte per entry, in the same (x fastest) order as
+    // the BaseFab so it is read in one piece
 
     // The data has one component
     RefCountedPtr<BaseFab<unsigned char> > data(new BaseFab<unsigned char>(dataBox,1));
 
-    // Start all loop counters at zero
-    IntVect state(IntVect::Zero);
-    int comp = 0;
+    long numPts = dataBox.numPts();
+    unsigned char* dataPtr = data->dataPtr();
 
-    bool first = true;
-    a_maxValue = 0.0;
+    a_file.read((char *)dataPtr,numPts);
 
-    // Loop until all loop counters are done
-    while (state[SpaceDim-1] < a_num[SpaceDim-1])
+    if (a_file.gcount() != numPts)
     {
-      Real curInput;
-
-      if (a_dataType == DataFileIF::ASCII)
-      {
-        // Read the next ASCII value and store the data
-        a_file >> curInput;
-      }
-      else
-      if (a_dataType == DataFileIF::Binary)
-      {
-        // Read the next binary byte and store the data
-        unsigned char curChar;
-        a_file.read((char *)(&curChar),1);
-
-        curInput = curChar;
-      }
-
-      (*data)(state,comp) = curInput;
-
-      // Update the maximum data value
-      if (first || a_maxValue < curInput)
-      {
-        first = false;
-        a_maxValue = curInput;
-      }
-
-      // Increment the indices as needed - increasing x most rapidly
-      for (int i = 0; i < SpaceDim; i++)
-      {
-        // Increment the counter
-        state[i]++;
+      MayDay::Abort("DataFileIF::ReadData - Not enough binary data in data file");
+    }
 
-        // Is the counter in bounds?
-        if (state[i] < a_num[i])
-        {
-          // If so, continue reading data
-          break;
-        }
-        else
-        {
-          // If not, zero the counter and increment the next (nested loops)
-          // unless this is the outermost loop counter
-          if (i < SpaceDim-1)
-          {
-            state[i] = 0;
-          }
-        }
-      }
+    // Find the maximum data value
+    unsigned char maxValue = 0;
+    for (long i = 0; i < numPts; i++)
+    {
+      maxValue = Max(maxValue,dataPtr[i]);
     }
+    a_maxValue = maxValue;
 
     m_ascii_data = RefCountedPtr<FArrayBox>(NULL);
     m_binary_data = data;
   }
+  else if (a_dataType == DataFileIF::MappedBinary)
+  {
+    MayDay::Abort("DataFileIF::ReadData - Mapped binary data must come from a named file");
+  }
   else
   {
     // Unknown data - an error
@@ -842,6 +857,59 @@ void DataFileIF::ReadData(Real&                       a_maxValue,
   }
 }
 
+void DataFileIF::MapData(Real&             a_maxValue,
+                         const char* const a_filename,
+                         const long&       a_offset,
+                         const IntVect&    a_num)
+{
+  // Box where the data is defined
+  Box dataBox(IntVect::Zero,a_num - IntVect::Unit);
+
+  long numPts = dataBox.numPts();
+
+  int fd = open(a_filename,O_RDONLY);
+
+  if (fd < 0)
+  {
+    MayDay::Abort("DataFileIF::MapData - Unable to open data file");
+  }
+
+  struct stat fileStat;
+
+  if (fstat(fd,&fileStat) != 0 || fileStat.st_size < a_offset + numPts)
+  {
+    close(fd);
+    MayDay::Abort("DataFileIF::MapData - Not enough binary data in data file");
+  }
+
+  size_t mapSize = fileStat.st_size;
+
+  // A private, writable mapping so nothing written through the BaseFab can
+  // reach the file
+  void* map = mmap(NULL,mapSize,PROT_READ | PROT_WRITE,MAP_PRIVATE,fd,0);
+
+  // The mapping stays valid once the file is closed
+  close(fd);
+
+  if (map == MAP_FAILED)
+  {
+    MayDay::Abort("DataFileIF::MapData - Unable to map data file");
+  }
+
+  unsigned char* dataPtr = (unsigned char*)map + a_offset;
+
+  // Find the maximum data value - this touches every page once, in order
+  unsigned char maxValue = 0;
+  for (long i = 0; i < numPts; i++)
+  {
+    maxValue = Max(maxValue,dataPtr[i]);
+  }
+  a_maxValue = maxValue;
+
+  m_ascii_data = RefCountedPtr<FArrayBox>(NULL);
+  m_binary_data = RefCountedPtr<BaseFab<unsigned char> >(new MappedDataFab(dataBox,dataPtr,map,mapSize));
+}
+
 void DataFileIF::MakeCorners(void)
 {
   // Make the end points of the linear interpolation box
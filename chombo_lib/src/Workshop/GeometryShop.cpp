@@ -550,6 +550,115 @@ GeometryService::InOut GeometryShop::InsideOutside(const Box&           a_region
   return rtn;
 }
 
+/**********************************************/
+void
+GeometryShop::fillCornerValues(BaseFab<Real>&  a_cornerValues,
+                               const Box&      a_region,
+                               const RealVect& a_origin,
+                               const Real&     a_dx) const
+{
+  CH_TIME("GeometryShop::fillCornerValues");
+
+  //same node spacing as InsideOutside
+  RealVect vectDx;
+  if (m_vectDx[0] != 0.0)
+    {
+      vectDx[0] = a_dx;
+      for (int idir = 1; idir < SpaceDim; idir++)
+        {
+          vectDx[idir] = vectDx[0] * m_vectDx[idir] / m_vectDx[0];
+        }
+    }
+  else
+    {
+      vectDx = a_dx * RealVect::Unit;
+    }
+
+  Box allCorners(a_region);
+  allCorners.surroundingNodes();
+  a_cornerValues.resize(allCorners, 1);
+
+  //points in the same order as the fab data so the values can go straight in
+  int npts = allCorners.numPts();
+  Vector<RealVect> points(npts);
+  int ipt = 0;
+  for (BoxIterator bit(allCorners); bit.ok(); ++bit, ++ipt)
+    {
+      const IntVect& corner = bit();
+      for (int idir = 0; idir < SpaceDim; ++idir)
+        {
+          points[ipt][idir] = vectDx[idir]*corner[idir] + a_origin[idir];
+        }
+    }
+  CH_assert(ipt == npts);
+
+  m_implicitFunction->value(&(points[0]), a_cornerValues.dataPtr(0), npts);
+}
+/**********************************************/
+GeometryService::InOut
+GeometryShop::cornerInsideOutside(const BaseFab<Real>& a_cornerValues,
+                                  const IntVect&       a_iv) const
+{
+  //this is the corner loop of InsideOutside for a one-cell box
+  Real firstValue = a_cornerValues(a_iv, 0);
+  Real firstSign  = copysign(1.0, firstValue);
+
+  GeometryService::InOut rtn;
+  if ( firstSign < 0 )
+    {
+      rtn = GeometryService::Regular;
+    }
+  else
+    {
+      rtn = GeometryService::Covered;
+    }
+
+  for (int icorner = 0; icorner < D_TERM(2,*2,*2); icorner++)
+    {
+      IntVect corner = a_iv;
+      for (int idir = 0; idir < SpaceDim; idir++)
+        {
+          if ((icorner >> idir) & 1)
+            {
+              corner[idir]++;
+            }
+        }
+
+      Real functionValue = a_cornerValues(corner, 0);
+      Real functionSign  = copysign(1.0, functionValue);
+
+      if (functionValue == 0 || firstValue == 0)
+        {
+          if (functionSign * firstSign < 0)
+            {
+              return GeometryService::Irregular;
+            }
+        }
+      if (functionValue * firstValue < 0.0 )
+        {
+          return GeometryService::Irregular;
+        }
+    }
+
+  return rtn;
+}
+
+/**********************************************/
+RealVect
+GeometryShop::fillVectDx(const Real& a_dx) const
+{
+  if (m_vectDx == RealVect::Zero)
+    {
+      return a_dx*RealVect::Unit;
+    }
+  return m_vectDx;
+}
+/**********************************************/
+void
+GeometryShop::prepareFillGraph(const Real& a_dx) const
+{
+  PolyGeom::setVectDx(fillVectDx(a_dx));
+}
 /**********************************************/
 /*********************************************/
 void
@@ -569,31 +678,44 @@ GeometryShop::fillGraph(BaseFab<int>        & a_regIrregCovered,
 
   CH_START(p1);
   CH_assert(a_domain.contains(a_ghostRegion));
-  RealVect vectDx;
   Real thrshd = m_thrshdVoF;
   // if (thrshd > 0)
   //   pout() << "GeometryShop:: Using thrshd: " << thrshd << endl;
-  if (m_vectDx == RealVect::Zero)
-    {
-      vectDx = a_dx*RealVect::Unit;
-    }
-  else
+  RealVect vectDx = fillVectDx(a_dx);
+
+  //only written if prepareFillGraph was not called, so threads just read it
+  if (PolyGeom::getVectDx() != vectDx)
     {
-      vectDx = m_vectDx;
+      PolyGeom::setVectDx(vectDx);
     }
-
-  PolyGeom::setVectDx(vectDx);
   IntVectSet ivsirreg = IntVectSet(DenseIntVectSet(a_ghostRegion, false));
   IntVectSet ivsdrop  = IntVectSet(DenseIntVectSet(a_ghostRegion, false));// CP
   long int numCovered=0, numReg=0, numIrreg=0;
   CH_STOP(p1);
 
   CH_START(p2);
+  //corner values are only needed for cells the implicit function cannot classify itself.
+  //the STL path has its own explorer so it still goes cell by cell.
+  BaseFab<Real> cornerValues;
+  bool haveCornerValues = false;
   for (BoxIterator bit(a_ghostRegion); bit.ok(); ++bit)
     {
       const IntVect iv =bit();
       Box miniBox(iv, iv);
-      GeometryService::InOut inout = InsideOutside(miniBox, a_domain, a_origin, a_dx);
+      GeometryService::InOut inout;
+      if ((m_stlIF == NULL) && !m_implicitFunction->fastIntersection(miniBox, a_domain, a_origin, a_dx))
+        {
+          if (!haveCornerValues)
+            {
+              fillCornerValues(cornerValues, a_ghostRegion, a_origin, a_dx);
+              haveCornerValues = true;
+            }
+          inout = cornerInsideOutside(cornerValues, iv);
+        }
+      else
+        {
+          inout = InsideOutside(miniBox, a_domain, a_origin, a_dx);
+        }
 
       if (inout == GeometryService::Covered)
         {
@@ -2158,6 +2280,8 @@ GeometryShop::computeVoFInternals(Real&               a_volFrac,
   if (thisVofClipped)
     {
       GeometryShop* changedThis = (GeometryShop *) this;
+      // boxes may be filled from several threads
+#pragma omp atomic
       changedThis->m_numCellsClipped += 1;
     }
 }
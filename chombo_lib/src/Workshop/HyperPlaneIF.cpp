@@ -91,6 +91,35 @@ Real HyperPlaneIF::value(const RealVect & a_point) const
   return value(pt);
 }
 
+void HyperPlaneIF::value(const RealVect* a_points,
+                         Real*           a_values,
+                         int             a_npts) const
+{
+  if (GLOBALDIM != SpaceDim)
+    {
+      BaseIF::value(a_points, a_values, a_npts);
+      return;
+    }
+
+  RealVect normal, point;
+  for (int idir = 0; idir < SpaceDim; idir++)
+    {
+      normal[idir] = m_normal[idir];
+      point[idir]  = m_point[idir];
+    }
+
+  Real sign = m_normalIn ? -1.0 : 1.0;
+  for (int ipt = 0; ipt < a_npts; ipt++)
+    {
+      Real retval = 0.0;
+      for (int idir = 0; idir < SpaceDim; idir++)
+        {
+          retval += (a_points[ipt][idir] - point[idir]) * normal[idir];
+        }
+      a_values[ipt] = sign*retval;
+    }
+}
+
 Real HyperPlaneIF::value(const IndexTM<Real,GLOBALDIM>& a_point) const
 {
   Real retval = 0.0;
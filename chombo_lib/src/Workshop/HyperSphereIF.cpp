@@ -92,6 +92,36 @@ Real HyperSphereIF::value(const RealVect & a_point) const
   return value(pt);
 }
 
+void HyperSphereIF::value(const RealVect* a_points,
+                          Real*           a_values,
+                          int             a_npts) const
+{
+  if (GLOBALDIM != SpaceDim)
+    {
+      BaseIF::value(a_points, a_values, a_npts);
+      return;
+    }
+
+  RealVect center;
+  for (int idir = 0; idir < SpaceDim; idir++)
+    {
+      center[idir] = m_center[idir];
+    }
+
+  // Same as the pointwise version with the sign flip pulled out of the loop
+  Real sign = m_inside ? 1.0 : -1.0;
+  for (int ipt = 0; ipt < a_npts; ipt++)
+    {
+      Real distance2 = 0.0;
+      for (int idir = 0; idir < SpaceDim; idir++)
+        {
+          Real cur = a_points[ipt][idir] - center[idir];
+          distance2 += cur*cur;
+        }
+      a_values[ipt] = sign*(distance2 - m_radius2);
+    }
+}
+
 Real HyperSphereIF::value(const IndexTM<Real,GLOBALDIM> & a_point) const
 {
   Real retval;
@@ -113,6 +113,36 @@ Real IntersectionIF::value(const RealVect& a_point) const
   return retval;
 }
 
+void IntersectionIF::value(const RealVect* a_points,
+                           Real*           a_values,
+                           int             a_npts) const
+{
+  if ((m_numFuncs == 0) || (a_npts <= 0))
+    {
+      for (int ipt = 0; ipt < a_npts; ipt++)
+        {
+          a_values[ipt] = -1.0;
+        }
+      return;
+    }
+
+  // Maximum of the implicit functions values, one function at a time
+  m_impFuncs[0]->value(a_points, a_values, a_npts);
+
+  Vector<Real> cur(a_npts);
+  for (int ifunc = 1; ifunc < m_numFuncs; ifunc++)
+    {
+      m_impFuncs[ifunc]->value(a_points, &(cur[0]), a_npts);
+      for (int ipt = 0; ipt < a_npts; ipt++)
+        {
+          if (cur[ipt] > a_values[ipt])
+            {
+              a_values[ipt] = cur[ipt];
+            }
+        }
+    }
+}
+
 Real IntersectionIF::value(const IndexTM<Real,GLOBALDIM>& a_point) const
 {
   int closestIF = -1;
@@ -195,6 +195,23 @@ Real MultiSphereIF::value(const RealVect& a_point) const
   return retval;
 }
 
+void MultiSphereIF::value(const RealVect* a_points,
+                          Real*           a_values,
+                          int             a_npts) const
+{
+  if (m_multiSphere != NULL)
+    {
+      m_multiSphere->value(a_points, a_values, a_npts);
+    }
+  else
+    {
+      for (int ipt = 0; ipt < a_npts; ipt++)
+        {
+          a_values[ipt] = 0.0;
+        }
+    }
+}
+
 BaseIF* MultiSphereIF::newImplicitFunction() const
 {
   MultiSphereIF* spherePtr = new MultiSphereIF(m_radii,
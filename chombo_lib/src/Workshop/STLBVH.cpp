@@ -0,0 +1,525 @@
+#ifdef CH_LANG_CC
+/*
+ *      _______              __
+ *     / ___/ /  ___  __ _  / /  ___
+ *    / /__/ _ \/ _ \/  V \/ _ \/ _ \
+ *    \___/_//_/\___/_/_/_/_.__/\___/
+ *    Please refer to Copyright.txt, in Chombo's root directory.
+ */
+#endif
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <cmath>
+
+#include "CH_Timer.H"
+#include "MayDay.H"
+#include "Misc.H"
+
+#include "STLBVH.H"
+
+#include "NamespaceHeader.H"
+
+// orders triangles by one coordinate of their centroids
+class STLBVHCentroidLess
+{
+public:
+  STLBVHCentroidLess(const Vector<RealVect>& a_centroids,
+                     const int&              a_dir)
+    :m_centroids(a_centroids),
+     m_dir(a_dir)
+  {
+  }
+
+  bool operator()(const int& a_tri1,
+                  const int& a_tri2) const
+  {
+    return (m_centroids[a_tri1][m_dir] < m_centroids[a_tri2][m_dir]);
+  }
+
+protected:
+  const Vector<RealVect>& m_centroids;
+  int                     m_dir;
+};
+
+STLBVH::STLBVH(RefCountedPtr<STLMesh> a_mesh)
+{
+  CH_TIME("STLBVH::STLBVH");
+
+  m_mesh = a_mesh;
+
+  int numTri = m_mesh->triangles.corners.size();
+
+  m_triangles.resize(numTri);
+  Vector<RealVect> centroids(numTri);
+
+  for (int itri = 0; itri < numTri; itri++)
+  {
+    m_triangles[itri] = itri;
+
+    centroids[itri] = RealVect::Zero;
+    for (int icorner = 0; icorner < SpaceDim; icorner++)
+    {
+      centroids[itri] += corner(itri,icorner);
+    }
+    centroids[itri] /= SpaceDim;
+  }
+
+  if (numTri > 0)
+  {
+    buildNode(0,numTri,centroids);
+  }
+
+  makePseudoNormals();
+}
+
+STLBVH::~STLBVH()
+{
+}
+
+Real STLBVH::signedDistance(const RealVect& a_point) const
+{
+  RealVect closest;
+  int feature;
+
+  int tri = findClosest(a_point,closest,feature);
+
+  if (tri < 0)
+  {
+    MayDay::Error("STLBVH::signedDistance - empty mesh");
+  }
+
+  RealVect diff = a_point - closest;
+  Real dist = diff.vectorLength();
+
+  const RealVect* normal;
+  if (feature == Face)
+  {
+    normal = &m_faceNormal[tri];
+  }
+  else if (feature < Vertex0)
+  {
+    normal = &m_edgeNormal[SpaceDim*tri + feature - Edge0];
+  }
+  else
+  {
+    int vertex = m_mesh->triangles.corners[tri][feature - Vertex0];
+    normal = &m_vertexNormal[vertex];
+  }
+
+  // the normals point inside
+  if (diff.dotProduct(*normal) > 0.0)
+  {
+    dist = -dist;
+  }
+
+  return dist;
+}
+
+Real STLBVH::distance(const RealVect& a_point) const
+{
+  RealVect closest;
+  int feature;
+
+  if (findClosest(a_point,closest,feature) < 0)
+  {
+    MayDay::Error("STLBVH::distance - empty mesh");
+  }
+
+  return (a_point - closest).vectorLength();
+}
+
+int STLBVH::closestTriangle(const RealVect& a_point,
+                            RealVect&       a_closest) const
+{
+  int feature;
+
+  return findClosest(a_point,a_closest,feature);
+}
+
+int STLBVH::buildNode(int               a_first,
+                      int               a_count,
+                      Vector<RealVect>& a_centroids)
+{
+  int index = m_nodes.size();
+  m_nodes.push_back(Node());
+
+  RealVect lo = corner(m_triangles[a_first],0);
+  RealVect hi = lo;
+  RealVect centLo = a_centroids[m_triangles[a_first]];
+  RealVect centHi = centLo;
+
+  for (int i = a_first; i < a_first + a_count; i++)
+  {
+    int itri = m_triangles[i];
+
+    for (int icorner = 0; icorner < SpaceDim; icorner++)
+    {
+      lo.min(corner(itri,icorner));
+      hi.max(corner(itri,icorner));
+    }
+
+    centLo.min(a_centroids[itri]);
+    centHi.max(a_centroids[itri]);
+  }
+
+  m_nodes[index].m_lo    = lo;
+  m_nodes[index].m_hi    = hi;
+  m_nodes[index].m_first = a_first;
+  m_nodes[index].m_count = a_count;
+  m_nodes[index].m_right = 0;
+
+  if (a_count > s_leafSize)
+  {
+    RealVect extent = centHi - centLo;
+
+    int splitDir = 0;
+    for (int idir = 1; idir < SpaceDim; idir++)
+    {
+      if (extent[idir] > extent[splitDir])
+      {
+        splitDir = idir;
+      }
+    }
+
+    int numLeft = a_count / 2;
+    int* tris = &(m_triangles[0]);
+
+    std::nth_element(tris + a_first,
+                     tris + a_first + numLeft,
+                     tris + a_first + a_count,
+                     STLBVHCentroidLess(a_centroids,splitDir));
+
+    buildNode(a_first,numLeft,a_centroids);
+
+    int right = buildNode(a_first + numLeft,a_count - numLeft,a_centroids);
+    m_nodes[index].m_right = right;
+  }
+
+  return index;
+}
+
+Real STLBVH::boxDistance2(const Node&     a_node,
+                          const RealVect& a_point) const
+{
+  Real dist2 = 0.0;
+
+  for (int idir = 0; idir < SpaceDim; idir++)
+  {
+    Real d = 0.0;
+    if (a_point[idir] < a_node.m_lo[idir])
+    {
+      d = a_node.m_lo[idir] - a_point[idir];
+    }
+    else if (a_point[idir] > a_node.m_hi[idir])
+    {
+      d = a_point[idir] - a_node.m_hi[idir];
+    }
+    dist2 += d*d;
+  }
+
+  return dist2;
+}
+
+Real STLBVH::closestOnTriangle(const RealVect& a_point,
+                               const int&      a_tri,
+                               RealVect&       a_closest,
+                               int&            a_feature) const
+{
+  const RealVect& a = corner(a_tri,0);
+  const RealVect& b = corner(a_tri,1);
+
+  RealVect ab = b - a;
+  RealVect ap = a_point - a;
+
+#if CH_SPACEDIM == 2
+  // closest point on the segment from a to b
+  Real len2 = ab.dotProduct(ab);
+  Real t = (len2 > 0.0) ? ap.dotProduct(ab) / len2 : 0.0;
+
+  if (t <= 0.0)
+  {
+    a_closest = a;
+    a_feature = Vertex0;
+  }
+  else if (t >= 1.0)
+  {
+    a_closest = b;
+    a_feature = Vertex0 + 1;
+  }
+  else
+  {
+    a_closest = a + t*ab;
+    a_feature = Face;
+  }
+#else
+  // closest point on the triangle a, b, c by its Voronoi regions
+  // (Ericson, "Real-Time Collision Detection", 5.1.5)
+  const RealVect& c = corner(a_tri,2);
+
+  RealVect ac = c - a;
+
+  Real d1 = ab.dotProduct(ap);
+  Real d2 = ac.dotProduct(ap);
+
+  if (d1 <= 0.0 && d2 <= 0.0)
+  {
+    a_closest = a;
+    a_feature = Vertex0;
+  }
+  else
+  {
+    RealVect bp = a_point - b;
+    Real d3 = ab.dotProduct(bp);
+    Real d4 = ac.dotProduct(bp);
+
+    RealVect cp = a_point - c;
+    Real d5 = ab.dotProduct(cp);
+    Real d6 = ac.dotProduct(cp);
+
+    Real vc = d1*d4 - d3*d2;
+    Real vb = d5*d2 - d1*d6;
+    Real va = d3*d6 - d5*d4;
+
+    if (d3 >= 0.0 && d4 <= d3)
+    {
+      a_closest = b;
+      a_feature = Vertex0 + 1;
+    }
+    else if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+    {
+      a_closest = a + (d1 / (d1 - d3))*ab;
+      a_feature = Edge0;
+    }
+    else if (d6 >= 0.0 && d5 <= d6)
+    {
+      a_closest = c;
+      a_feature = Vertex0 + 2;
+    }
+    else if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+    {
+      a_closest = a + (d2 / (d2 - d6))*ac;
+      a_feature = Edge0 + 2;
+    }
+    else if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0)
+    {
+      a_closest = b + ((d4 - d3) / ((d4 - d3) + (d5 - d6)))*(c - b);
+      a_feature = Edge0 + 1;
+    }
+    else
+    {
+      Real denom = va + vb + vc;
+
+      if (denom > 0.0)
+      {
+        a_closest = a + (vb/denom)*ab + (vc/denom)*ac;
+        a_feature = Face;
+      }
+      else
+      {
+        // degenerate triangle
+        a_closest = a;
+        a_feature = Vertex0;
+      }
+    }
+  }
+#endif
+
+  RealVect diff = a_point - a_closest;
+
+  return diff.dotProduct(diff);
+}
+
+int STLBVH::findClosest(const RealVect& a_point,
+                        RealVect&       a_closest,
+                        int&            a_feature) const
+{
+  int bestTri = -1;
+
+  if (m_nodes.size() == 0)
+  {
+    return bestTri;
+  }
+
+  Real bestDist2 = HUGE_VAL;
+
+  // the tree is balanced so its depth is about log2 of the number of leaves
+  const int maxStack = 64;
+  int stack[maxStack];
+  int top = 0;
+
+  stack[top++] = 0;
+
+  while (top > 0)
+  {
+    const Node& node = m_nodes[stack[--top]];
+
+    if (boxDistance2(node,a_point) >= bestDist2)
+    {
+      continue;
+    }
+
+    if (node.m_right == 0)
+    {
+      for (int i = node.m_first; i < node.m_first + node.m_count; i++)
+      {
+        int itri = m_triangles[i];
+
+        RealVect closest;
+        int feature;
+        Real dist2 = closestOnTriangle(a_point,itri,closest,feature);
+
+        if (dist2 < bestDist2)
+        {
+          bestDist2 = dist2;
+          bestTri   = itri;
+          a_closest = closest;
+          a_feature = feature;
+        }
+      }
+    }
+    else
+    {
+      int left  = (&node - &m_nodes[0]) + 1;
+      int right = node.m_right;
+
+      Real leftDist2  = boxDistance2(m_nodes[left] ,a_point);
+      Real rightDist2 = boxDistance2(m_nodes[right],a_point);
+
+      CH_assert(top + 2 <= maxStack);
+
+      // push the nearer child last so it is searched first
+      if (leftDist2 < rightDist2)
+      {
+        if (rightDist2 < bestDist2) stack[top++] = right;
+        stack[top++] = left;
+      }
+      else
+      {
+        if (leftDist2 < bestDist2) stack[top++] = left;
+        stack[top++] = right;
+      }
+    }
+  }
+
+  return bestTri;
+}
+
+void STLBVH::makePseudoNormals()
+{
+  CH_TIME("STLBVH::makePseudoNormals");
+
+  int numTri  = m_mesh->triangles.corners.size();
+  int numVert = m_mesh->vertices.vertex.size();
+
+  m_faceNormal.resize(numTri);
+  m_vertexNormal.resize(numVert,RealVect::Zero);
+
+  for (int itri = 0; itri < numTri; itri++)
+  {
+    const RealVect& a = corner(itri,0);
+    const RealVect& b = corner(itri,1);
+
+    RealVect normal;
+
+#if CH_SPACEDIM == 2
+    normal[0] = -(b[1] - a[1]);
+    normal[1] =   b[0] - a[0];
+#else
+    const RealVect& c = corner(itri,2);
+
+    RealVect ab = b - a;
+    RealVect ac = c - a;
+
+    normal[0] = ab[1]*ac[2] - ab[2]*ac[1];
+    normal[1] = ab[2]*ac[0] - ab[0]*ac[2];
+    normal[2] = ab[0]*ac[1] - ab[1]*ac[0];
+#endif
+
+    // the file normal says which side is inside, the corners give an
+    // exact direction
+    if (normal.dotProduct(m_mesh->triangles.normal[itri]) < 0.0)
+    {
+      normal = -normal;
+    }
+
+    Real length = normal.vectorLength();
+    if (length > 0.0)
+    {
+      normal /= length;
+    }
+
+    m_faceNormal[itri] = normal;
+  }
+
+#if CH_SPACEDIM == 2
+  // each vertex is shared by (at most) two segments
+  for (int itri = 0; itri < numTri; itri++)
+  {
+    for (int icorner = 0; icorner < SpaceDim; icorner++)
+    {
+      m_vertexNormal[m_mesh->triangles.corners[itri][icorner]] += m_faceNormal[itri];
+    }
+  }
+#else
+  // edges are matched by their (sorted) vertex indices
+  std::map<std::pair<int,int>,RealVect> edgeNormals;
+
+  for (int itri = 0; itri < numTri; itri++)
+  {
+    const Vector<int>& corners = m_mesh->triangles.corners[itri];
+
+    for (int icorner = 0; icorner < SpaceDim; icorner++)
+    {
+      int v0 = corners[icorner];
+      int v1 = corners[(icorner+1) % SpaceDim];
+      int vPrev = corners[(icorner+SpaceDim-1) % SpaceDim];
+
+      std::pair<int,int> edge(std::min(v0,v1),std::max(v0,v1));
+      std::map<std::pair<int,int>,RealVect>::iterator it = edgeNormals.find(edge);
+      if (it == edgeNormals.end())
+      {
+        edgeNormals[edge] = m_faceNormal[itri];
+      }
+      else
+      {
+        it->second += m_faceNormal[itri];
+      }
+
+      // weight the vertex normals by the angle at the vertex
+      RealVect e1 = m_mesh->vertices.vertex[v1]    - m_mesh->vertices.vertex[v0];
+      RealVect e2 = m_mesh->vertices.vertex[vPrev] - m_mesh->vertices.vertex[v0];
+
+      Real len1 = e1.vectorLength();
+      Real len2 = e2.vectorLength();
+
+      if (len1 > 0.0 && len2 > 0.0)
+      {
+        Real cosAngle = e1.dotProduct(e2) / (len1*len2);
+        cosAngle = Max((Real)-1.0,Min((Real)1.0,cosAngle));
+
+        m_vertexNormal[v0] += acos(cosAngle) * m_faceNormal[itri];
+      }
+    }
+  }
+
+  m_edgeNormal.resize(SpaceDim*numTri);
+
+  for (int itri = 0; itri < numTri; itri++)
+  {
+    const Vector<int>& corners = m_mesh->triangles.corners[itri];
+
+    for (int icorner = 0; icorner < SpaceDim; icorner++)
+    {
+      int v0 = corners[icorner];
+      int v1 = corners[(icorner+1) % SpaceDim];
+
+      std::pair<int,int> edge(std::min(v0,v1),std::max(v0,v1));
+      m_edgeNormal[SpaceDim*itri + icorner] = edgeNormals[edge];
+    }
+  }
+#endif
+}
+
+#include "NamespaceFooter.H"
@@ -39,9 +39,11 @@ STLIF::STLIF(const STLIF& a_inputIF)
   m_filename = a_inputIF.m_filename;
   m_dataType = a_inputIF.m_dataType;
 
-  m_explorer = NULL;
+  m_mesh = a_inputIF.m_mesh;
+  m_bvh  = a_inputIF.m_bvh;
 
-  makeExplorer();
+  // the explorer keeps per query state so each copy gets its own
+  m_explorer = new STLExplorer(m_mesh);
 }
 
 STLIF::~STLIF()
@@ -56,19 +58,14 @@ STLIF::~STLIF()
 
 Real STLIF::value(const RealVect& a_point) const
 {
-  Real retval = 0.0;
-
-  MayDay::Error("STLIF::value should never be called");
-
-  return retval;
+  return m_bvh->signedDistance(a_point);
 }
 
 BaseIF* STLIF::newImplicitFunction() const
 {
   CH_TIME("STLIF::newImplicitFunction");
 
-  STLIF* dataFilePtr = new STLIF(m_filename.c_str(),
-                                 m_dataType);
+  STLIF* dataFilePtr = new STLIF(*this);
 
   return static_cast<BaseIF*>(dataFilePtr);
 }
@@ -87,24 +84,23 @@ void STLIF::makeExplorer()
 {
   CH_TIME("STLIF::makeExplorer");
 
-  RefCountedPtr<STLMesh> mesh;
-
   if (m_dataType == STLIF::ASCII)
   {
     STLAsciiReader reader(m_filename);
-    mesh = reader.GetMesh();
+    m_mesh = reader.GetMesh();
   }
   else if (m_dataType == STLIF::Binary)
   {
     STLBinaryReader reader(m_filename);
-    mesh = reader.GetMesh();
+    m_mesh = reader.GetMesh();
   }
   else
   {
     MayDay::Error("STLIF::makeExplorer - Unknown STL data type");
   }
 
-  m_explorer = new STLExplorer(mesh);
+  m_explorer = new STLExplorer(m_mesh);
+  m_bvh = RefCountedPtr<STLBVH>(new STLBVH(m_mesh));
 }
 
 #include "NamespaceFooter.H"
@@ -316,6 +316,25 @@ Real TransformIF::value(const RealVect& a_point) const
   return retval;
 }
 
+void TransformIF::value(const RealVect* a_points,
+                        Real*           a_values,
+                        int             a_npts) const
+{
+  if (a_npts <= 0)
+    {
+      return;
+    }
+
+  // Inverse transform all the points and evaluate them together
+  Vector<RealVect> invPoints(a_npts);
+  for (int ipt = 0; ipt < a_npts; ipt++)
+    {
+      vectorMultiply(invPoints[ipt],m_invTransform,a_points[ipt]);
+    }
+
+  m_impFunc->value(&(invPoints[0]), a_values, a_npts);
+}
+
 Real TransformIF::value(const IndexTM<Real,GLOBALDIM>& a_point) const
 {
   RealVect point;
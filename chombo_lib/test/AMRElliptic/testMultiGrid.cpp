@@ -23,6 +23,7 @@ using std::endl;
 #include "AMRPoissonOp.H"
 #include "BCFunc.H"
 #include "BiCGStabSolver.H"
+#include "AMRKrylovMultiGrid.H"
 #include "CH_Timer.H"
 
 #include "UsingNamespace.H"
@@ -430,5 +431,77 @@ testMultiGrid()
     delete op;
   }
 
-  return 0;
+  pout()<<"\n Krylov-accelerated AMR solver \n";
+  // two-level solve with each AMRKrylovMultiGrid method
+  int status = 0;
+  {
+    ProblemDomain coarseDomain(coarsen(domain, 2));
+    Vector<DisjointBoxLayout> grids(2);
+    Vector<Box> coarseBoxes;
+    domainSplit(coarseDomain, coarseBoxes, 16);
+    Vector<int> procs;
+    LoadBalance(procs, coarseBoxes);
+    grids[0].define(coarseBoxes, procs, coarseDomain);
+    makeGrids(grids[1], domain);
+    grids[1].close();
+
+    Vector<int> refRatios(2, 2);
+    AMRPoissonOpFactory opFactory;
+    opFactory.define(coarseDomain, grids, refRatios, 2*dx, DirParabolaBC);
+
+    Vector<LevelData<FArrayBox>*> phi(2, NULL);
+    Vector<LevelData<FArrayBox>*> rhs(2, NULL);
+    for (int lev = 0; lev < 2; lev++)
+      {
+        phi[lev] = new LevelData<FArrayBox>(grids[lev], 1, IntVect::Unit);
+        rhs[lev] = new LevelData<FArrayBox>(grids[lev], 1);
+        setvalue::val = 2*CH_SPACEDIM;
+        rhs[lev]->apply(setvalue::setFunc);
+      }
+
+    BiCGStabSolver<LevelData<FArrayBox> > bottomSolver;
+    bottomSolver.m_verbosity = 0;
+    for (int method = AMRKrylovMultiGrid<FArrayBox>::KrylovNone;
+         method < AMRKrylovMultiGrid<FArrayBox>::NUMKRYLOVMETHODS; method++)
+      {
+        AMRKrylovMultiGrid<FArrayBox> solver;
+        solver.setKrylovMethod(method);
+        solver.define(coarseDomain, opFactory, &bottomSolver, 2);
+        solver.setSolverParameters(2, 2, 2, 1, 30, 1.0e-9, 1.0e-15, 1.0e-30);
+        solver.m_verbosity = verbose ? 3 : 0;
+        solver.solve(phi, rhs, 1, 0, true);
+        pout()<<indent<<"krylov method "<<method
+              <<"  exit status "<<solver.m_exitStatus<<std::endl;
+        // bit 1 is set when the residual was reduced by m_eps
+        if ((solver.m_exitStatus & 1) == 0)
+          {
+            pout()<<indent<<"krylov method "<<method<<" did not converge"<<std::endl;
+            status = 1;
+          }
+      }
+
+    // full multigrid start, then V-cycles
+    {
+      AMRMultiGrid<LevelData<FArrayBox> > solver;
+      solver.define(coarseDomain, opFactory, &bottomSolver, 2);
+      solver.setSolverParameters(2, 2, 2, 1, 30, 1.0e-9, 1.0e-15, 1.0e-30);
+      solver.setInitialGuess(true, false);
+      solver.m_verbosity = verbose ? 4 : 0;
+      solver.solve(phi, rhs, 1, 0, true);
+      pout()<<indent<<"full multigrid start  exit status "<<solver.m_exitStatus<<std::endl;
+      if ((solver.m_exitStatus & 1) == 0)
+        {
+          pout()<<indent<<"full multigrid start did not converge"<<std::endl;
+          status = 1;
+        }
+    }
+
+    for (int lev = 0; lev < 2; lev++)
+      {
+        delete phi[lev];
+        delete rhs[lev];
+      }
+  }
+
+  return status;
 }
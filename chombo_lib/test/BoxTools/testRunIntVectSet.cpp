@@ -0,0 +1,302 @@
+#ifdef CH_LANG_CC
+/*
+ *      _______              __
+ *     / ___/ /  ___  __ _  / /  ___
+ *    / /__/ _ \/ _ \/  V \/ _ \/ _ \
+ *    \___/_//_/\___/_/_/_/_.__/\___/
+ *    Please refer to Copyright.txt, in Chombo's root directory.
+ */
+#endif
+
+#include <cstring>
+#include "REAL.H"
+#include "Box.H"
+#include "Vector.H"
+#include "parstream.H"
+#include "IntVectSet.H"
+#include "RunIntVectSet.H"
+#include "DenseIntVectSet.H"
+#include "BoxIterator.H"
+#ifdef CH_MPI
+#include <mpi.h>
+#endif
+#include "UsingNamespace.H"
+using std::endl;
+
+/// Prototypes:
+
+void
+parseTestOptions( int argc ,char* argv[] ) ;
+
+int
+testRunIntVectSet();
+
+/// Global variables for handling output:
+static const char *pgmname = "testRunIntVectSet" ;
+static const char *indent2 = "      " ;
+static bool verbose = true ;
+
+/// Code:
+
+int
+main(int argc, char* argv[])
+{
+#ifdef CH_MPI
+  MPI_Init(&argc, &argv);
+#endif
+  parseTestOptions( argc ,argv ) ;
+
+  if ( verbose )
+    pout() << indent2 << "Beginning " << pgmname << " ..." << endl ;
+
+  ///
+  // Run the tests
+  ///
+  int ret = testRunIntVectSet() ;
+  if (ret == 0)
+    pout() << indent2 << pgmname << " passed." << endl ;
+  else
+    pout() << indent2 << pgmname << " failed." << endl ;
+#ifdef CH_MPI
+  MPI_Finalize();
+#endif
+  return ret;
+}
+
+// true if a_runs and a_dense hold the same cells
+static bool
+sameCells(const RunIntVectSet& a_runs, const DenseIntVectSet& a_dense)
+{
+  int count = 0;
+  for (RunIntVectSetIterator it(a_runs); it.ok(); ++it)
+    {
+      if (!a_dense.box().contains(it()) || !a_dense[it()]) return false;
+      count++;
+    }
+  return (count == a_dense.numPts());
+}
+
+// a spherical shell one cell thick: the sort of set irregular cells make
+static void
+makeShell(RunIntVectSet& a_runs, DenseIntVectSet& a_dense, int a_radius, const IntVect& a_center)
+{
+  Box region(a_center - (a_radius+1)*IntVect::Unit, a_center + (a_radius+1)*IntVect::Unit);
+  for (BoxIterator bit(region); bit.ok(); ++bit)
+    {
+      IntVect dist = bit() - a_center;
+      int r2 = 0;
+      for (int idir = 0; idir < SpaceDim; idir++)
+        {
+          r2 += dist[idir]*dist[idir];
+        }
+      if ((r2 >= a_radius*a_radius) && (r2 < (a_radius+1)*(a_radius+1)))
+        {
+          a_runs  |= bit();
+          a_dense |= bit();
+        }
+    }
+}
+
+int
+testRunIntVectSet()
+{
+  Box domain(-32*IntVect::Unit, 32*IntVect::Unit);
+  IntVect center1 = IntVect::Zero;
+  IntVect center2 = 5*BASISV(0) - 3*BASISV(SpaceDim-1);
+
+  RunIntVectSet runs1, runs2;
+  DenseIntVectSet dense1(domain, false), dense2(domain, false);
+  makeShell(runs1, dense1, 12, center1);
+  makeShell(runs2, dense2, 9, center2);
+  if (!sameCells(runs1, dense1) || !sameCells(runs2, dense2))
+    {
+      pout() << indent2 << "shell built wrong: " << pgmname << endl ;
+      return 1;
+    }
+
+  {
+    // cells added out of order, and more than once
+    RunIntVectSet runs;
+    for (RunIntVectSetIterator it(runs2); it.ok(); ++it)
+      {
+        runs |= -it();
+        runs |= -it();
+      }
+    runs.shift(2*center2);
+    runs.refine(2);
+    runs.coarsen(2);
+    runs.shift(IntVect::Zero);
+    RunIntVectSet flipped;
+    for (RunIntVectSetIterator it(runs); it.ok(); ++it)
+      {
+        flipped |= 2*center2 - it() ;
+      }
+    if (!(flipped == runs2))
+      {
+        pout() << indent2 << "out of order union wrong: " << pgmname << endl ;
+        return 2;
+      }
+  }
+
+  {
+    RunIntVectSet runs = runs1;
+    DenseIntVectSet dense = dense1;
+    runs  |= runs2;
+    dense |= dense2;
+    if (!sameCells(runs, dense))
+      {
+        pout() << indent2 << "union wrong: " << pgmname << endl ;
+        return 3;
+      }
+    runs  -= runs2;
+    dense -= dense2;
+    if (!sameCells(runs, dense))
+      {
+        pout() << indent2 << "difference wrong: " << pgmname << endl ;
+        return 3;
+      }
+  }
+
+  {
+    RunIntVectSet runs = runs1;
+    DenseIntVectSet dense = dense1;
+    runs.grow(1);
+    dense.grow(1);
+    runs  &= runs2;
+    dense &= dense2;
+    if (!sameCells(runs, dense))
+      {
+        pout() << indent2 << "grow and intersection wrong: " << pgmname << endl ;
+        return 4;
+      }
+  }
+
+  {
+    RunIntVectSet runs = runs1;
+    DenseIntVectSet dense = dense1;
+    runs.grow(2);
+    dense.grow(2);
+    runs.grow(-1);
+    dense.grow(-1);
+    runs.growHi();
+    dense.growHi();
+    if (!sameCells(runs, dense))
+      {
+        pout() << indent2 << "grow wrong: " << pgmname << endl ;
+        return 5;
+      }
+  }
+
+  {
+    RunIntVectSet runs = runs1;
+    runs.coarsen(4);
+    Box coarseDomain = coarsen(domain, 4);
+    DenseIntVectSet dense(coarseDomain, false);
+    for (RunIntVectSetIterator it(runs1); it.ok(); ++it)
+      {
+        dense |= coarsen(it(), 4);
+      }
+    if (!sameCells(runs, dense))
+      {
+        pout() << indent2 << "coarsen wrong: " << pgmname << endl ;
+        return 6;
+      }
+  }
+
+  {
+    Vector<char> buffer(runs1.linearSize());
+    runs1.linearOut(&(buffer[0]));
+    RunIntVectSet runs;
+    runs.linearIn(&(buffer[0]));
+    RunIntVectSet hi = runs.chop(SpaceDim-1, 3);
+    runs |= hi;
+    if (!(runs == runs1) || (runs.numPts() != dense1.numPts()))
+      {
+        pout() << indent2 << "linearization or chop wrong: " << pgmname << endl ;
+        return 7;
+      }
+  }
+
+  {
+    // IntVectSet picks runs for a sparse set built a cell at a time,
+    // and a bitmap again once it is compressed over a small box
+    IntVectSet ivs;
+    for (RunIntVectSetIterator it(runs1); it.ok(); ++it)
+      {
+        ivs |= it();
+      }
+    if (!ivs.isRun() || (ivs.numPts() != dense1.numPts()) ||
+        !(ivs == IntVectSet(dense1)))
+      {
+        pout() << indent2 << "IntVectSet did not use runs: " << pgmname << endl ;
+        return 8;
+      }
+    IntVectSet bigBox(domain);
+    bigBox &= ivs;
+    if (bigBox.numPts() != dense1.numPts())
+      {
+        pout() << indent2 << "IntVectSet intersection wrong: " << pgmname << endl ;
+        return 8;
+      }
+    ivs.compress();
+    if (!ivs.isDense() || (ivs.numPts() != dense1.numPts()))
+      {
+        pout() << indent2 << "IntVectSet compress wrong: " << pgmname << endl ;
+        return 8;
+      }
+  }
+
+  {
+    // sets of different representations compare by content, and a tree
+    // with cells outside the runs' box is not equal to them
+    Box box(IntVect::Zero, 3*IntVect::Unit);
+    IntVectSet runs(box);
+    runs.convertToRuns();
+    IntVectSet dense(box);
+    IntVectSet tree(box);
+    tree.convert();
+    IntVectSet bigTree(box);
+    bigTree |= 10*IntVect::Unit;
+    bigTree.convert();
+    if (!(runs == dense) || !(runs == tree) || (runs == bigTree) ||
+        (runs < dense) || (dense < runs) || (runs < tree) || (tree < runs) ||
+        ((runs < bigTree) == (bigTree < runs)))
+      {
+        pout() << indent2 << "IntVectSet comparison wrong: " << pgmname << endl ;
+        return 9;
+      }
+  }
+
+  return 0;
+}
+
+///
+// Parse the standard test options (-v -q) out of the command line.
+// Stop parsing when a non-option argument is found.
+///
+void
+parseTestOptions( int argc ,char* argv[] )
+{
+  for ( int i = 1 ; i < argc ; ++i )
+    {
+      if ( argv[i][0] == '-' ) //if it is an option
+        {
+          // compare 3 chars to differentiate -x from -xx
+          if ( strncmp( argv[i] ,"-v" ,3 ) == 0 )
+            {
+              verbose = true ;
+              // argv[i] = "" ;
+            }
+          else if ( strncmp( argv[i] ,"-q" ,3 ) == 0 )
+            {
+              verbose = false ;
+              // argv[i] = "" ;
+            }
+          else
+            {
+              break ;
+            }
+        }
+    }
+  return ;
+}
@@ -0,0 +1,326 @@
+#ifdef CH_LANG_CC
+/*
+ *      _______              __
+ *     / ___/ /  ___  __ _  / /  ___
+ *    / /__/ _ \/ _ \/  V \/ _ \/ _ \
+ *    \___/_//_/\___/_/_/_/_.__/\___/
+ *    Please refer to Copyright.txt, in Chombo's root directory.
+ */
+#endif
+
+#include <cstring>
+#include "REAL.H"
+#include "Box.H"
+#include "Vector.H"
+#include "parstream.H"
+#include "BoxIterator.H"
+#include "EBGraph.H"
+#include "IrregNode.H"
+#ifdef CH_MPI
+#include <mpi.h>
+#endif
+#include "UsingNamespace.H"
+using std::endl;
+
+/// Prototypes:
+
+void
+parseTestOptions( int argc ,char* argv[] ) ;
+
+int
+testCompactGraph();
+
+/// Global variables for handling output:
+static const char *pgmname = "compactGraphTest" ;
+static const char *indent2 = "      " ;
+static bool verbose = true ;
+
+/// Code:
+
+int
+main(int argc, char* argv[])
+{
+#ifdef CH_MPI
+  MPI_Init(&argc, &argv);
+#endif
+  parseTestOptions( argc ,argv ) ;
+
+  if ( verbose )
+    pout() << indent2 << "Beginning " << pgmname << " ..." << endl ;
+
+  ///
+  // Run the tests
+  ///
+  int ret = testCompactGraph() ;
+  if (ret == 0)
+    pout() << indent2 << pgmname << " passed." << endl ;
+  else
+    pout() << indent2 << pgmname << " failed." << endl ;
+#ifdef CH_MPI
+  MPI_Finalize();
+#endif
+  return ret;
+}
+
+// cells x = 4 and x = 5 are irregular, with no face between them, so the
+// coarse cells over them hold two vofs.  x < 2 is covered, the rest regular.
+static void
+makeFineGraph(EBGraph& a_graph, const ProblemDomain& a_domain)
+{
+  const Box& region = a_domain.domainBox();
+  BaseFab<int> regIrregCovered(region, 1);
+  Vector<IrregNode> nodes;
+  for (BoxIterator bit(region); bit.ok(); ++bit)
+    {
+      const IntVect& iv = bit();
+      if (iv[0] < 2)
+        {
+          regIrregCovered(iv, 0) = -1;
+        }
+      else if ((iv[0] != 4) && (iv[0] != 5))
+        {
+          regIrregCovered(iv, 0) = 1;
+        }
+      else
+        {
+          regIrregCovered(iv, 0) = 0;
+          IrregNode node;
+          node.m_cell = iv;
+          node.m_cellIndex = 0;
+          for (int idir = 0; idir < SpaceDim; idir++)
+            {
+              for (SideIterator sit; sit.ok(); ++sit)
+                {
+                  Vector<int>& arcs = node.m_arc[IrregNode::index(idir, sit())];
+                  IntVect otherIV = iv + sign(sit())*BASISV(idir);
+                  if (!a_domain.contains(otherIV))
+                    {
+                      arcs.push_back(-1);
+                    }
+                  else if (idir == 0)
+                    {
+                      bool wall = ((iv[0] == 4) && (sit() == Side::Hi)) ||
+                                  ((iv[0] == 5) && (sit() == Side::Lo));
+                      if (!wall)
+                        {
+                          arcs.push_back(-2);
+                        }
+                    }
+                  else
+                    {
+                      arcs.push_back(0);
+                    }
+                }
+            }
+          nodes.push_back(node);
+        }
+    }
+  a_graph.setDomain(a_domain);
+  a_graph.buildGraph(regIrregCovered, nodes, region, a_domain);
+}
+
+// Vector has no operator==
+template <class T> static bool
+same(const Vector<T>& a_one, const Vector<T>& a_two)
+{
+  if (a_one.size() != a_two.size()) return false;
+  for (int i = 0; i < a_one.size(); i++)
+    {
+      if (!(a_one[i] == a_two[i])) return false;
+    }
+  return true;
+}
+
+// a dense copy of a_graph
+static void
+denseCopy(EBGraph& a_copy, const EBGraph& a_graph)
+{
+  const Box& region = a_graph.getRegion();
+  Interval interv(0, 0);
+  a_copy.define(region);
+  a_copy.setDomain(a_graph.getDomain());
+  a_copy.copy(region, interv, region, a_graph, interv);
+}
+
+// true if a_graph serializes to exactly a_bytes
+static bool
+sameBytes(const EBGraph& a_graph, const Vector<char>& a_bytes)
+{
+  const Box& region = a_graph.getRegion();
+  Interval interv(0, 0);
+  int size = a_graph.size(region, interv);
+  if (size != a_bytes.size()) return false;
+  Vector<char> bytes(size);
+  a_graph.linearOut(&(bytes[0]), region, interv);
+  return (memcmp(&(bytes[0]), &(a_bytes[0]), size) == 0);
+}
+
+// every query answered the same by the dense and the compact graph
+static int
+compareGraphs(const EBGraph& a_dense, const EBGraph& a_compact)
+{
+  const Box& region = a_dense.getRegion();
+  for (BoxIterator bit(region); bit.ok(); ++bit)
+    {
+      const IntVect& iv = bit();
+      if ((a_dense.isRegular(iv)   != a_compact.isRegular(iv))   ||
+          (a_dense.isCovered(iv)   != a_compact.isCovered(iv))   ||
+          (a_dense.isIrregular(iv) != a_compact.isIrregular(iv)) ||
+          (a_dense.numVoFs(iv)     != a_compact.numVoFs(iv)))
+        {
+          pout() << indent2 << "cell type wrong at " << iv << endl;
+          return 1;
+        }
+      Vector<VolIndex> vofs = a_dense.getVoFs(iv);
+      if (!same(vofs, a_compact.getVoFs(iv)))
+        {
+          pout() << indent2 << "vofs wrong at " << iv << endl;
+          return 2;
+        }
+      for (int ivof = 0; ivof < vofs.size(); ivof++)
+        {
+          const VolIndex& vof = vofs[ivof];
+          for (int idir = 0; idir < SpaceDim; idir++)
+            {
+              for (SideIterator sit; sit.ok(); ++sit)
+                {
+                  if (!same(a_dense.getFaces(vof, idir, sit()), a_compact.getFaces(vof, idir, sit())))
+                    {
+                      pout() << indent2 << "faces wrong at " << vof << endl;
+                      return 3;
+                    }
+                }
+            }
+          if (!same(a_dense.refine(vof), a_compact.refine(vof)) ||
+              (a_dense.coarsen(vof) != a_compact.coarsen(vof)))
+            {
+              pout() << indent2 << "refine or coarsen wrong at " << vof << endl;
+              return 4;
+            }
+        }
+    }
+  for (int idir = 0; idir < SpaceDim; idir++)
+    {
+      if (!same(a_dense.getIrregFaces(region, idir), a_compact.getIrregFaces(region, idir)))
+        {
+          pout() << indent2 << "irregular faces wrong" << endl;
+          return 5;
+        }
+    }
+  BaseFab<char> denseMask(region, 1), compactMask(region, 1);
+  a_dense.fillMask(denseMask);
+  a_compact.fillMask(compactMask);
+  for (BoxIterator bit(region); bit.ok(); ++bit)
+    {
+      if (denseMask(bit(), 0) != compactMask(bit(), 0))
+        {
+          pout() << indent2 << "mask wrong at " << bit() << endl;
+          return 6;
+        }
+    }
+  return 0;
+}
+
+// compact a copy of a_graph, compare it with a_graph, and expand it again
+static int
+checkGraph(const EBGraph& a_graph)
+{
+  EBGraph compact;
+  denseCopy(compact, a_graph);
+  compact.compact();
+  if (!compact.isCompact())
+    {
+      pout() << indent2 << "graph not compacted" << endl;
+      return 10;
+    }
+
+  int ret = compareGraphs(a_graph, compact);
+  if (ret != 0) return ret;
+
+  const Box& region = a_graph.getRegion();
+  Interval interv(0, 0);
+  Vector<char> bytes(a_graph.size(region, interv));
+  a_graph.linearOut(&(bytes[0]), region, interv);
+  if (!sameBytes(compact, bytes))
+    {
+      pout() << indent2 << "compact linearization wrong" << endl;
+      return 11;
+    }
+
+  // copying from a compact graph
+  EBGraph copied;
+  denseCopy(copied, compact);
+  if (copied.isCompact() || !sameBytes(copied, bytes))
+    {
+      pout() << indent2 << "copy from compact graph wrong" << endl;
+      return 12;
+    }
+
+  // copying to a compact graph expands it
+  compact.copy(region, interv, region, a_graph, interv);
+  if (compact.isCompact() || !sameBytes(compact, bytes))
+    {
+      pout() << indent2 << "copy to compact graph wrong" << endl;
+      return 13;
+    }
+  return compareGraphs(a_graph, compact);
+}
+
+int
+testCompactGraph()
+{
+  Box domainBox(IntVect::Zero, 7*IntVect::Unit);
+  ProblemDomain fineDomain(domainBox);
+  EBGraph fine(domainBox);
+  makeFineGraph(fine, fineDomain);
+
+  Box coarBox = coarsen(domainBox, 2);
+  EBGraph coar(coarBox);
+  coar.coarsenVoFs(fine, coarBox);
+  coar.coarsenFaces(coar, fine);
+  coar.fixFineToCoarse(fine);
+
+  if (coar.getMultiCells(coarBox).numPts() != coarBox.numPts()/4)
+    {
+      pout() << indent2 << "expected multivalued coarse cells" << endl;
+      return 20;
+    }
+
+  int ret = checkGraph(fine);
+  if (ret == 0)
+    {
+      ret = checkGraph(coar);
+    }
+  return ret;
+}
+
+///
+// Parse the standard test options (-v -q) out of the command line.
+// Stop parsing when a non-option argument is found.
+///
+void
+parseTestOptions( int argc ,char* argv[] )
+{
+  for ( int i = 1 ; i < argc ; ++i )
+    {
+      if ( argv[i][0] == '-' ) //if it is an option
+        {
+          // compare 3 chars to differentiate -x from -xx
+          if ( strncmp( argv[i] ,"-v" ,3 ) == 0 )
+            {
+              verbose = true ;
+              // argv[i] = "" ;
+            }
+          else if ( strncmp( argv[i] ,"-q" ,3 ) == 0 )
+            {
+              verbose = false ;
+              // argv[i] = "" ;
+            }
+          else
+            {
+              break ;
+            }
+        }
+    }
+  return ;
+}
@@ -353,6 +353,53 @@ int checkFabIndex(const EBISLayout& a_ebisl,
         }
 
 
+    }
+  //the sorted index has to give the same answers as the dense one.
+  //irregular cells are the case it is there for.
+  for (DataIterator dit=a_grids.dataIterator(); dit.ok(); ++dit)
+    {
+      const Box& localBox = a_grids.get(dit());
+      const EBISBox& ebisBox = a_ebisl[dit()];
+      IntVectSet irregIVS = ebisBox.getIrregIVS(localBox);
+
+      BaseIVFAB<int>::setDenseFillFraction(0.0);
+      BaseIVFAB<int> denseivfab(irregIVS, ebisBox.getEBGraph(), nvar);
+      BaseIVFAB<int>::setDenseFillFraction(2.0);
+      BaseIVFAB<int> sparseivfab(irregIVS, ebisBox.getEBGraph(), nvar);
+      BaseIVFAB<int>::setDenseFillFraction(0.25);
+      if (!irregIVS.isEmpty() && (denseivfab.hasSparseIndex() || !sparseivfab.hasSparseIndex()))
+        {
+          eekflag = 21;
+          return eekflag;
+        }
+
+      VoFIterator vofit(irregIVS, ebisBox.getEBGraph());
+      for (vofit.reset(); vofit.ok(); ++vofit)
+        {
+          for (int ivar = 0; ivar < nvar; ivar++)
+            {
+              int rightans = getFabVal(vofit().gridIndex(), ivar) + 10*vofit().cellIndex();
+              denseivfab(vofit(), ivar)  = rightans;
+              sparseivfab(vofit(), ivar) = rightans;
+            }
+        }
+      for (vofit.reset(); vofit.ok(); ++vofit)
+        {
+          for (int ivar = 0; ivar < nvar; ivar++)
+            {
+              int rightans = getFabVal(vofit().gridIndex(), ivar) + 10*vofit().cellIndex();
+              if (sparseivfab(vofit(), ivar) != rightans)
+                {
+                  eekflag = 22;
+                  return eekflag;
+                }
+              if (sparseivfab.offset(vofit(), ivar) != denseivfab.offset(vofit(), ivar))
+                {
+                  eekflag = 23;
+                  return eekflag;
+                }
+            }
+        }
     }
   //now do the face fabs.
   for (DataIterator dit=a_grids.dataIterator(); dit.ok(); ++dit)
@@ -0,0 +1,296 @@
+#ifdef CH_LANG_CC
+/*
+ *      _______              __
+ *     / ___/ /  ___  __ _  / /  ___
+ *    / /__/ _ \/ _ \/  V \/ _ \/ _ \
+ *    \___/_//_/\___/_/_/_/_.__/\___/
+ *    Please refer to Copyright.txt, in Chombo's root directory.
+ */
+#endif
+
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+#include <fstream>
+#include "REAL.H"
+#include "RealVect.H"
+#include "Vector.H"
+#include "parstream.H"
+#include "BoxIterator.H"
+#include "STLMesh.H"
+#include "STLBVH.H"
+#include "DataFileIF.H"
+#ifdef CH_MPI
+#include <mpi.h>
+#endif
+#include "UsingNamespace.H"
+using std::endl;
+
+/// Prototypes:
+
+void
+parseTestOptions( int argc ,char* argv[] ) ;
+
+int
+testSTLBVH();
+
+int
+testMappedDataFile();
+
+/// Global variables for handling output:
+static const char *pgmname = "stlBVHTest" ;
+static const char *indent2 = "      " ;
+static bool verbose = true ;
+
+/// Code:
+
+int
+main(int argc, char* argv[])
+{
+#ifdef CH_MPI
+  MPI_Init(&argc, &argv);
+#endif
+  parseTestOptions( argc ,argv ) ;
+
+  if ( verbose )
+    pout() << indent2 << "Beginning " << pgmname << " ..." << endl ;
+
+  ///
+  // Run the tests
+  ///
+  int ret = testSTLBVH() ;
+  if (ret == 0)
+    {
+      ret = testMappedDataFile() ;
+    }
+  if (ret == 0)
+    pout() << indent2 << pgmname << " passed." << endl ;
+  else
+    pout() << indent2 << pgmname << " failed." << endl ;
+#ifdef CH_MPI
+  MPI_Finalize();
+#endif
+  return ret;
+}
+
+// the surface of [-1,1]^SpaceDim, normals pointing in, with every face
+// cut into a_numCut x a_numCut squares (two triangles each in 3D)
+static RefCountedPtr<STLMesh>
+makeCube(int a_numCut)
+{
+  RefCountedPtr<STLMesh> mesh(new STLMesh());
+  Box nodes(IntVect::Zero, a_numCut*IntVect::Unit);
+  for (BoxIterator bit(nodes); bit.ok(); ++bit)
+    {
+      RealVect vertex;
+      for (int idir = 0; idir < SpaceDim; idir++)
+        {
+          vertex[idir] = -1.0 + (2.0*bit()[idir])/a_numCut;
+        }
+      mesh->vertices.vertex.push_back(vertex);
+    }
+
+  for (int idir = 0; idir < SpaceDim; idir++)
+    {
+      for (int iside = 0; iside < 2; iside++)
+        {
+          RealVect normal = RealVect::Zero;
+          normal[idir] = (iside == 0) ? 1.0 : -1.0;
+
+          // the cells of the face, as low corners
+          IntVect hi = (a_numCut-1)*IntVect::Unit;
+          hi[idir] = 0;
+          for (BoxIterator bit(Box(IntVect::Zero, hi)); bit.ok(); ++bit)
+            {
+              IntVect lo = bit();
+              lo[idir] = iside*a_numCut;
+#if CH_SPACEDIM == 2
+              Vector<int> segment(2);
+              segment[0] = nodes.index(lo);
+              segment[1] = nodes.index(lo + BASISV(1-idir));
+              mesh->triangles.corners.push_back(segment);
+              mesh->triangles.normal.push_back(normal);
+#else
+              int dir1 = (idir+1) % 3;
+              int dir2 = (idir+2) % 3;
+              int v00 = nodes.index(lo);
+              int v10 = nodes.index(lo + BASISV(dir1));
+              int v11 = nodes.index(lo + BASISV(dir1) + BASISV(dir2));
+              int v01 = nodes.index(lo + BASISV(dir2));
+              Vector<int> tri(3);
+              tri[0] = v00; tri[1] = v10; tri[2] = v11;
+              mesh->triangles.corners.push_back(tri);
+              mesh->triangles.normal.push_back(normal);
+              tri[0] = v00; tri[1] = v11; tri[2] = v01;
+              mesh->triangles.corners.push_back(tri);
+              mesh->triangles.normal.push_back(normal);
+#endif
+            }
+        }
+    }
+
+  return mesh;
+}
+
+// signed distance to [-1,1]^SpaceDim
+static Real
+cubeDistance(const RealVect& a_point)
+{
+  Real outside2 = 0.0;
+  Real inside = -HUGE_VAL;
+  for (int idir = 0; idir < SpaceDim; idir++)
+    {
+      Real q = Abs(a_point[idir]) - 1.0;
+      if (q > 0.0)
+        {
+          outside2 += q*q;
+        }
+      inside = Max(inside, q);
+    }
+  return (outside2 > 0.0) ? sqrt(outside2) : inside;
+}
+
+int
+testSTLBVH()
+{
+  RefCountedPtr<STLMesh> mesh = makeCube(8);
+  STLBVH bvh(mesh);
+
+  if (bvh.numNodes() < 3)
+    {
+      pout() << indent2 << "tree not built: " << pgmname << endl ;
+      return 1;
+    }
+
+  // points on a lattice that is not aligned with the mesh, inside and out
+  int numWrong = 0;
+  int numInside = 0;
+  Box samples(-7*IntVect::Unit, 7*IntVect::Unit);
+  for (BoxIterator bit(samples); bit.ok(); ++bit)
+    {
+      RealVect point;
+      for (int idir = 0; idir < SpaceDim; idir++)
+        {
+          point[idir] = 0.213*bit()[idir] + 0.011*(idir+1);
+        }
+
+      Real exact = cubeDistance(point);
+      Real dist  = bvh.signedDistance(point);
+
+      if (Abs(dist - exact) > 1.0e-10)
+        {
+          if (verbose && numWrong < 10)
+            {
+              pout() << indent2 << "at " << point << " distance " << dist
+                     << " should be " << exact << endl;
+            }
+          numWrong++;
+        }
+      if (bvh.isInside(point))
+        {
+          numInside++;
+        }
+    }
+
+  if (numWrong > 0)
+    {
+      pout() << indent2 << "signed distance wrong: " << pgmname << endl ;
+      return 2;
+    }
+  if (numInside == 0 || numInside == samples.numPts())
+    {
+      pout() << indent2 << "inside test wrong: " << pgmname << endl ;
+      return 3;
+    }
+
+  // closest to an edge and a corner of the cube, from outside
+  RealVect closest;
+  RealVect point = 2.0*RealVect::Unit;
+  if (bvh.closestTriangle(point, closest) < 0 ||
+      (closest - RealVect::Unit).vectorLength() > 1.0e-12)
+    {
+      pout() << indent2 << "closest point wrong: " << pgmname << endl ;
+      return 4;
+    }
+
+  return 0;
+}
+
+// the same bytes read and memory mapped give the same function
+int
+testMappedDataFile()
+{
+  const char* filename = "stlBVHTest.dat";
+  IntVect num = 6*IntVect::Unit;
+  num[0] = 7;
+  Box dataBox(IntVect::Zero, num - IntVect::Unit);
+  {
+    std::ofstream out(filename, std::ios::binary);
+    out << D_TERM(num[0], << " " << num[1], << " " << num[2]) << "\n";
+    out << D_TERM(0.5, << " " << 0.5, << " " << 0.5) << "\n";
+    out << D_TERM(0.0, << " " << 0.0, << " " << 0.0) << "\n";
+    for (BoxIterator bit(dataBox); bit.ok(); ++bit)
+      {
+        unsigned char value = (unsigned char)(bit().sum()*7 % 251);
+        out.write((char*)&value, 1);
+      }
+  }
+
+  DataFileIF readIF  (filename, DataFileIF::Binary,       100.0, true);
+  DataFileIF mappedIF(filename, DataFileIF::MappedBinary, 100.0, true);
+
+  BaseIF* copyIF = mappedIF.newImplicitFunction();
+
+  int ret = 0;
+  for (BoxIterator bit(Box(-IntVect::Unit, 2*num)); bit.ok(); ++bit)
+    {
+      RealVect point;
+      for (int idir = 0; idir < SpaceDim; idir++)
+        {
+          point[idir] = 0.1713*bit()[idir];
+        }
+      Real value = readIF.value(point);
+      if (value != mappedIF.value(point) || value != copyIF->value(point))
+        {
+          pout() << indent2 << "mapped data wrong: " << pgmname << endl ;
+          ret = 5;
+          break;
+        }
+    }
+
+  delete copyIF;
+  remove(filename);
+
+  return ret;
+}
+
+///
+// Parse the standard test options (-v -q) out of the command line.
+// Stop parsing when a non-option argument is found.
+///
+void
+parseTestOptions( int argc ,char* argv[] )
+{
+  for ( int i = 1 ; i < argc ; ++i )
+    {
+      if ( argv[i][0] == '-' ) //if it is an option
+        {
+          // compare 3 chars to differentiate -x from -xx
+          if ( strncmp( argv[i] ,"-v" ,3 ) == 0 )
+            {
+              verbose = true ;
+              // argv[i] = "" ;
+            }
+          else if ( strncmp( argv[i] ,"-q" ,3 ) == 0 )
+            {
+              verbose = false ;
+              // argv[i] = "" ;
+            }
+          else
+            {
+              break ;
+            }
+        }
+    }
+  return ;
+}